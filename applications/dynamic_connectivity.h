@@ -0,0 +1,174 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_DYNAMIC_CONNECTIVITY_H
+#define ALGS_DYNAMIC_CONNECTIVITY_H
+
+#include <assert.h>
+#include <map>
+#include <vector>
+#include <random>
+#include <utility>
+#include <iostream>
+#include "../unionfind.h"
+
+/**
+ * Offline dynamic connectivity: edges are inserted and deleted over time and queries ask whether two vertices
+ * are connected at that point. The whole stream is recorded first, then solve() answers every query, in
+ * O((n + m + q) log q log n) for m edge insertions and q queries.
+ *
+ * An edge is present during an interval of queries. The intervals are stored in a segment tree over the
+ * queries, each in O(log q) nodes. A depth-first walk of the tree joins the edges of a node on the way down,
+ * answers the query of each leaf, and rolls the joins back on the way up, so that at every leaf the union-find
+ * holds exactly the edges present at that query.
+ */
+class OfflineDynamicConnectivity {
+    typedef std::pair<unsigned long, unsigned long> Edge;
+
+    struct EdgeInterval {
+        Edge edge;
+        size_t from;
+        size_t to;
+    };
+
+public:
+    OfflineDynamicConnectivity(unsigned long n) : vertex_count(n) {}
+
+    // Parallel edges are allowed, each insertion needs its own deletion.
+    void addEdge(unsigned long a, unsigned long b) {
+        assert(a < vertex_count && b < vertex_count);
+        open_edges[edgeKey(a, b)].push_back(queries.size());
+    }
+
+    // Returns false and records nothing if the edge is not present.
+    bool removeEdge(unsigned long a, unsigned long b) {
+        auto it = open_edges.find(edgeKey(a, b));
+        if (it == open_edges.end()) return false;
+        intervals.push_back({it->first, it->second.back(), queries.size()});
+        it->second.pop_back();
+        if (it->second.empty()) open_edges.erase(it);
+        return true;
+    }
+
+    // Asks whether a and b are connected after the events recorded so far.
+    void query(unsigned long a, unsigned long b) {
+        assert(a < vertex_count && b < vertex_count);
+        queries.push_back(std::make_pair(a, b));
+    }
+
+    // Answers to the queries, in the order they were asked. Edges that were never removed last until the end.
+    std::vector<bool> solve() {
+        auto q = queries.size();
+        std::vector<bool> answers(q);
+        if (q == 0) return answers;
+
+        std::vector<std::vector<Edge> > segments(4 * q);
+        for (auto& interval : intervals) {
+            insert(segments, 1, 0, q, interval);
+        }
+        for (auto& open : open_edges) {
+            for (auto from : open.second) insert(segments, 1, 0, q, {open.first, from, q});
+        }
+
+        RollbackUF uf(vertex_count);
+        walk(segments, uf, 1, 0, q, answers);
+        return answers;
+    }
+
+private:
+    static Edge edgeKey(unsigned long a, unsigned long b) {
+        return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+    }
+
+    // Node covers the queries [lo, hi).
+    void insert(std::vector<std::vector<Edge> >& segments, size_t node, size_t lo, size_t hi,
+                const EdgeInterval& interval) {
+        if (interval.to <= lo || hi <= interval.from) return;
+        if (interval.from <= lo && hi <= interval.to) {
+            segments[node].push_back(interval.edge);
+            return;
+        }
+        auto mid = lo + (hi - lo) / 2;
+        insert(segments, 2 * node, lo, mid, interval);
+        insert(segments, 2 * node + 1, mid, hi, interval);
+    }
+
+    void walk(const std::vector<std::vector<Edge> >& segments, RollbackUF& uf, size_t node, size_t lo, size_t hi,
+              std::vector<bool>& answers) {
+        auto checkpoint = uf.checkpoint();
+        for (auto& edge : segments[node]) {
+            uf.join(edge.first, edge.second);
+        }
+        if (hi - lo == 1) {
+            answers[lo] = uf.connected(queries[lo].first, queries[lo].second);
+        }
+        else {
+            auto mid = lo + (hi - lo) / 2;
+            walk(segments, uf, 2 * node, lo, mid, answers);
+            walk(segments, uf, 2 * node + 1, mid, hi, answers);
+        }
+        uf.rollback(checkpoint);
+    }
+
+    unsigned long vertex_count;
+    std::vector<Edge> queries;
+    std::vector<EdgeInterval> intervals;
+    // Query counts at the insertions of the edges that are still present.
+    std::map<Edge, std::vector<size_t> > open_edges;
+};
+
+// Replays a random stream of insertions, deletions and queries, and checks every answer against a union-find
+// rebuilt from the edges present at the query.
+bool testDynamicConnectivityRandom(unsigned long n, size_t events, unsigned long seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<unsigned long> vertex(0, n - 1);
+    OfflineDynamicConnectivity connectivity(n);
+    std::vector<std::pair<unsigned long, unsigned long> > present;
+    std::vector<bool> expected;
+
+    for (size_t i = 0; i < events; i++) {
+        auto kind = gen() % 3;
+        if (kind == 0 || present.empty()) {
+            auto edge = std::make_pair(vertex(gen), vertex(gen));
+            connectivity.addEdge(edge.first, edge.second);
+            present.push_back(edge);
+        }
+        else if (kind == 1) {
+            auto k = gen() % present.size();
+            connectivity.removeEdge(present[k].first, present[k].second);
+            present[k] = present.back();
+            present.pop_back();
+        }
+        else {
+            auto a = vertex(gen), b = vertex(gen);
+            connectivity.query(a, b);
+            WeightedQuickUnionUF uf(n);
+            for (auto& edge : present) uf.join(edge.first, edge.second);
+            expected.push_back(uf.connected(a, b));
+        }
+    }
+    return connectivity.solve() == expected;
+}
+
+void testDynamicConnectivity() {
+    std::cout << "Test offline dynamic connectivity.\n";
+    OfflineDynamicConnectivity connectivity(5);
+    connectivity.addEdge(0, 1);
+    connectivity.addEdge(1, 2);
+    connectivity.query(0, 2);
+    connectivity.removeEdge(2, 1);
+    connectivity.query(0, 2);
+    std::cout << "Removing an edge that is not present: " << connectivity.removeEdge(2, 1) << "\n";
+    connectivity.addEdge(2, 3);
+    connectivity.addEdge(3, 0);
+    connectivity.query(0, 2);
+    connectivity.query(4, 0);
+    for (auto answer : connectivity.solve()) std::cout << answer << " ";
+    std::cout << "\n";
+
+    std::cout << "Random streams match a rebuilt union find: "
+              << (testDynamicConnectivityRandom(20, 2000, 1) && testDynamicConnectivityRandom(200, 5000, 2)) << "\n";
+}
+
+#endif //ALGS_DYNAMIC_CONNECTIVITY_H
@@ -6,67 +6,368 @@
 #define ALGS_PERCOLATION_H
 
 #include <assert.h>
-#include <deque>
+#include <cmath>
 #include <array>
+#include <atomic>
+#include <random>
+#include <limits>
+#include <numeric>
+#include <type_traits>
 #include "../unionfind.h"
-
-class Percolation {
-    // 0 index is top virtual site and site_count + 1 index is bottom virtual site.
-    const size_t additional_virtual_site_count = 2;
+#include "../graph.h"
+#include "../thread_pool.h"
+#include "../fast_random.h"
+
+// Boundary flags of a site: whether it is in the top or the bottom layer of the lattice.
+const unsigned char percolation_touches_top = 1;
+const unsigned char percolation_touches_bottom = 2;
+
+/**
+ * Lattice of n^Dimension sites, with nearest neighbors along each axis. The last axis goes from the top layer
+ * to the bottom one.
+ *
+ * The sites are indexed in a grid padded with a layer of sites on every side, that are never open, so the
+ * 2 * Dimension neighbors of a site are always at fixed offsets of its index and need no bounds checks.
+ */
+template <size_t Dimension>
+class HypercubicLattice {
 public:
-    Percolation(size_t _n) :
-            site_count(_n * _n),
-            uf(site_count + additional_virtual_site_count),
-            uf_no_virtual_bottom(site_count + additional_virtual_site_count / 2),
-            open_sites(site_count + 1, false),
-            grid_size(_n) {
-        // Connect top sites to virtual top site.
-        for (size_t i = 1, j = 1; j <= grid_size; j++) {
-            uf.join(topSite(), to1d(i, j));
-            uf_no_virtual_bottom.join(topSite(), to1d(i, j));
+    typedef uint32_t Index;
+
+    explicit HypercubicLattice(size_t n) : side(n), site_count(1), index_count(1) {
+        static_assert(Dimension > 0, "Lattices have at least one dimension.");
+        assert(n > 0);
+        for (size_t d = 0; d < Dimension; d++) {
+            // Every index has to be an element of the union-find.
+            if (index_count > CompactUF<Index>::max_size / (n + 2)) {
+                throw std::length_error("HypercubicLattice: too many sites for 32 bit indices.");
+            }
+            strides[d] = index_count;
+            index_count *= n + 2;
+            site_count *= n;
         }
+    }
 
-        // Connect bottom sites to virtual bottom site.
-        for (size_t i = grid_size, j = 1; j <= grid_size; j++) {
-            uf.join(bottomSite(), to1d(i, j));
+    size_t sideLength() const { return side; }
+    size_t siteCount() const { return site_count; }
+    // Size of the padded grid, indices are below it.
+    size_t indexCount() const { return index_count; }
+
+    // Index of the site at coordinates in [1, n], the first one varying fastest.
+    Index index(const std::array<size_t, Dimension>& coordinates) const {
+        size_t site = 0;
+        for (size_t d = 0; d < Dimension; d++) {
+            assert(coordinates[d] >= 1 && coordinates[d] <= side);
+            site += coordinates[d] * strides[d];
         }
+        return (Index) site;
     }
 
-    void open(size_t i, size_t j) {
-        open_sites[to1d(i, j)] = true;
-        open_sites_count++;
+    std::array<size_t, Dimension> coordinates(Index site) const {
+        std::array<size_t, Dimension> result;
+        for (size_t d = 0; d < Dimension; d++) result[d] = site / strides[d] % (side + 2);
+        return result;
+    }
 
-        auto neighbor_array = neighbors(i, j);
-        size_t i1, j1;
+    template <typename Visit>
+    void forEachSite(Visit visit) const {
+        forEachCoordinates([&visit](Index site, const std::array<size_t, Dimension>&) { visit(site); });
+    }
 
-        for (auto neighbor : neighbor_array) {
-            std::tie(i1, j1) = neighbor;
-            if (validIndex(i1, j1) && isOpen(i1, j1)) {
-                uf.join(to1d(i, j), to1d(i1, j1));
-                uf_no_virtual_bottom.join(to1d(i, j), to1d(i1, j1));
+    // Neighbors in the padding are included, they are never open.
+    template <typename Visit>
+    void forEachNeighbor(Index site, Visit visit) const {
+        for (size_t d = 0; d < Dimension; d++) {
+            visit((Index) (site - strides[d]));
+            visit((Index) (site + strides[d]));
+        }
+    }
+
+    template <typename Visit>
+    void forEachBond(Visit visit) const {
+        forEachCoordinates([this, &visit](Index site, const std::array<size_t, Dimension>& coordinates) {
+            for (size_t d = 0; d < Dimension; d++) {
+                if (coordinates[d] < side) visit(site, (Index) (site + strides[d]));
             }
+        });
+    }
+
+    unsigned char boundary(Index site) const {
+        auto layer = site / strides[Dimension - 1];
+        return (layer == 1 ? percolation_touches_top : 0) | (layer == side ? percolation_touches_bottom : 0);
+    }
+
+private:
+    // Visits the sites in order of index, with their coordinates.
+    template <typename Visit>
+    void forEachCoordinates(Visit visit) const {
+        std::array<size_t, Dimension> coordinates;
+        coordinates.fill(1);
+        size_t site = 0;
+        for (size_t d = 0; d < Dimension; d++) site += strides[d];
+        while (true) {
+            visit((Index) site, coordinates);
+            size_t d = 0;
+            for (; d < Dimension && coordinates[d] == side; d++) {
+                coordinates[d] = 1;
+                site -= (side - 1) * strides[d];
+            }
+            if (d == Dimension) return;
+            coordinates[d]++;
+            site += strides[d];
         }
     }
 
-    bool isOpen(size_t i, size_t j) {
-        assert(validIndex(i, j));
-        return getOpenSite(i, j) == true;
+    size_t side;
+    size_t site_count;
+    size_t index_count;
+    std::array<size_t, Dimension> strides;
+};
+
+typedef HypercubicLattice<2> SquareLattice;
+typedef HypercubicLattice<3> CubicLattice;
+
+/**
+ * The vertices of a Graph as sites and its edges as bonds, percolating from a set of top vertices to a set of
+ * bottom ones. The graph is not copied and has to outlive the lattice.
+ */
+class GraphLattice {
+public:
+    typedef uint32_t Index;
+
+    GraphLattice(const Graph& g, const std::vector<int>& top, const std::vector<int>& bottom) :
+            graph(&g), boundaries((size_t) g.vertexCount()) {
+        for (auto v : top) boundaries[v] |= percolation_touches_top;
+        for (auto v : bottom) boundaries[v] |= percolation_touches_bottom;
     }
 
-    bool isFull(size_t i, size_t j) {
-        assert(validIndex(i, j));
-        assert(isOpen(i, j));
-        return uf.connected(topSite(), to1d(i, j));
+    size_t siteCount() const { return boundaries.size(); }
+    size_t indexCount() const { return boundaries.size(); }
+
+    template <typename Visit>
+    void forEachSite(Visit visit) const {
+        for (size_t v = 0; v < boundaries.size(); v++) visit((Index) v);
+    }
+
+    template <typename Visit>
+    void forEachNeighbor(Index site, Visit visit) const {
+        for (auto range = graph->adjacent((int) site); range.first != range.second; ++range.first) {
+            visit((Index) *range.first);
+        }
+    }
+
+    // Every edge once, parallel edges included, self loops left out.
+    template <typename Visit>
+    void forEachBond(Visit visit) const {
+        for (size_t v = 0; v < boundaries.size(); v++) {
+            for (auto range = graph->adjacent((int) v); range.first != range.second; ++range.first) {
+                if ((size_t) *range.first > v) visit((Index) v, (Index) *range.first);
+            }
+        }
+    }
+
+    unsigned char boundary(Index site) const { return boundaries[site]; }
+
+private:
+    const Graph* graph;
+    std::vector<unsigned char> boundaries;
+};
+
+// Site percolation opens sites, neighbors connect when both are open.
+struct SitePercolation {};
+// Bond percolation opens bonds, every site is present and bonds connect their two ends.
+struct BondPercolation {};
+
+/**
+ * Percolation on any lattice, the elements of the Mode, sites or bonds, are opened one at a time until a
+ * cluster connects the top of the lattice to its bottom.
+ *
+ * A Lattice provides siteCount(), indexCount() with every site index below it, forEachSite(visit),
+ * forEachNeighbor(site, visit), forEachBond(visit) and boundary(site), the percolation_touches_ flags of a site.
+ *
+ * Open elements are a bitset. A single union-find joins the connected sites, and every root keeps two flags
+ * telling whether its component touches the top or the bottom, instead of virtual top and bottom sites.
+ * Fullness is then exact without the second union-find the virtual bottom needed against backwash, and
+ * percolation is detected the moment a component gets both flags.
+ *
+ * The elements are also kept in an array whose first getOpenElementCount() entries are the open ones, so that
+ * a random blocked element is one draw from the rest of the array rather than a retry until one is hit.
+ */
+template <typename Lattice, typename Mode = SitePercolation>
+class PercolationSystem {
+protected:
+    typedef uint32_t Index;
+
+public:
+    explicit PercolationSystem(const Lattice& _lattice) :
+            grid(_lattice),
+            uf(grid.indexCount()),
+            flags(grid.indexCount()),
+            boundary_flags(grid.indexCount()) {
+        grid.forEachSite([this](Index site) { boundary_flags[site] = grid.boundary(site); });
+        initializeElements(Mode());
+        open_bits.resize((positions.size() + 63) / 64);
+        reset();
+    }
+
+    // Blocks every element again, reusing the storage of the previous experiment. The elements go back to their
+    // initial order, so that the same random draws open the same elements after a reset as on a new system.
+    void reset() {
+        resetElements(Mode());
+        uf.reset();
+        std::fill(open_bits.begin(), open_bits.end(), 0);
+        flags = boundary_flags;
+        open_count = 0;
+        largest_cluster = std::is_same<Mode, BondPercolation>::value && grid.siteCount() > 0 ? 1 : 0;
+        percolated = false;
+        if (std::is_same<Mode, BondPercolation>::value) {
+            for (auto f : flags) percolated |= f == (percolation_touches_top | percolation_touches_bottom);
+        }
+    }
+
+    // Opens an element: a site index of the lattice, or a bond in [0, getElementCount()).
+    void open(Index element) {
+        if (isOpen(element)) return;
+        markOpen(element);
+        connect(element, Mode());
+    }
+
+    // Opens a blocked element chosen uniformly at random. There has to be one.
+    template <typename Engine>
+    void openRandomBlockedElement(Engine& gen) {
+        Index element = randomBlockedElement(gen);
+        markOpen(element);
+        connect(element, Mode());
+    }
+
+    bool isOpen(Index element) const {
+        return (open_bits[element / 64] >> (element % 64)) & 1;
+    }
+
+    // Whether the site is connected to the top, it has to be open in site percolation.
+    bool isFull(Index site) {
+        assert((std::is_same<Mode, BondPercolation>::value || isOpen(site)));
+        return flags[uf.find(site)] & percolation_touches_top;
+    }
+
+    bool percolates() const { return percolated; }
+
+    const Lattice& lattice() const { return grid; }
+    // Number of sites, or bonds, that can be opened.
+    size_t getElementCount() const { return elements.size(); }
+    size_t getOpenElementCount() const { return open_count; }
+    // Number of sites of the largest cluster.
+    size_t getLargestClusterSize() const { return largest_cluster; }
+
+    // Endpoints of a bond, in bond percolation.
+    std::pair<Index, Index> bond(Index b) const { return bonds[b]; }
+
+protected:
+    template <typename Engine>
+    Index randomBlockedElement(Engine& gen) {
+        assert(open_count < elements.size());
+        return elements[open_count + bounded_random(gen, elements.size() - open_count)];
+    }
+
+private:
+    void initializeElements(SitePercolation) {
+        elements.resize(grid.siteCount());
+        positions.resize(grid.indexCount());
+    }
+
+    void initializeElements(BondPercolation) {
+        grid.forEachBond([this](Index a, Index b) { bonds.push_back(std::make_pair(a, b)); });
+        elements.resize(bonds.size());
+        positions.resize(bonds.size());
+    }
+
+    void resetElements(SitePercolation) {
+        Index k = 0;
+        grid.forEachSite([this, &k](Index site) {
+            elements[k] = site;
+            positions[site] = k++;
+        });
+    }
+
+    void resetElements(BondPercolation) {
+        std::iota(elements.begin(), elements.end(), 0);
+        std::iota(positions.begin(), positions.end(), 0);
+    }
+
+    // Sets the open bit and swaps the element into the open prefix of elements.
+    void markOpen(Index element) {
+        open_bits[element / 64] |= 1ULL << (element % 64);
+        Index other = elements[open_count];
+        std::swap(elements[positions[element]], elements[open_count]);
+        std::swap(positions[element], positions[other]);
+        open_count++;
+    }
+
+    void connect(Index site, SitePercolation) {
+        unsigned char component_flags = flags[site];
+        grid.forEachNeighbor(site, [this, site, &component_flags](Index neighbor) {
+            if (isOpen(neighbor)) {
+                component_flags |= flags[uf.find(neighbor)];
+                uf.join(site, neighbor);
+            }
+        });
+        updateComponent(uf.find(site), component_flags);
+    }
+
+    void connect(Index b, BondPercolation) {
+        auto a = bonds[b].first, c = bonds[b].second;
+        unsigned char component_flags = flags[uf.find(a)] | flags[uf.find(c)];
+        uf.join(a, c);
+        updateComponent(uf.find(a), component_flags);
     }
 
-    bool isFullNoVirtual(size_t i, size_t j) {
+    void updateComponent(Index root, unsigned char component_flags) {
+        flags[root] = component_flags;
+        if (component_flags == (percolation_touches_top | percolation_touches_bottom)) percolated = true;
+        largest_cluster = std::max(largest_cluster, (size_t) uf.componentSize(root));
+    }
+
+    Lattice grid;
+    CompactUF<Index> uf;
+    // percolation_touches_ flags of every component, valid at its root.
+    std::vector<unsigned char> flags;
+    std::vector<unsigned char> boundary_flags;
+    std::vector<uint64_t> open_bits;
+    // Elements in order of opening, then the blocked ones. positions is the inverse permutation.
+    std::vector<Index> elements;
+    std::vector<Index> positions;
+    std::vector<std::pair<Index, Index> > bonds;
+    size_t open_count = 0;
+    size_t largest_cluster = 0;
+    bool percolated = false;
+};
+
+/**
+ * Site percolation on an nxn grid, sites are opened one at a time until the top row connects to the bottom row.
+ * Rows and columns are numbered from 1 to n.
+ */
+class Percolation : public PercolationSystem<SquareLattice> {
+public:
+    Percolation(size_t _n) : PercolationSystem(SquareLattice(_n)), grid_size(_n), stride(_n + 2) {}
+
+    void open(size_t i, size_t j) {
+        PercolationSystem::open(to1d(i, j));
+    }
+
+    // Opens a blocked site chosen uniformly at random. There has to be one.
+    template <typename Engine>
+    void openRandomBlockedSite(Engine& gen) {
+        openRandomBlockedElement(gen);
+    }
+
+    bool isOpen(size_t i, size_t j) {
         assert(validIndex(i, j));
-        assert(isOpen(i, j));
-        return uf_no_virtual_bottom.connected(topSite(), to1d(i, j));
+        return PercolationSystem::isOpen(to1d(i, j));
     }
 
-    bool percolates() {
-        return uf.connected(topSite(), bottomSite());
+    bool isFull(size_t i, size_t j) {
+        assert(validIndex(i, j));
+        return PercolationSystem::isFull(to1d(i, j));
     }
 
     void print() {
@@ -80,7 +381,7 @@ public:
                 if (j == 0 || j == grid_size + 1) { std::cout << "|"; continue; }
 
                 if (!isOpen(i, j)) { std::cout << "w"; continue; }
-                if (isFullNoVirtual(i, j)) std::cout << " ";
+                if (isFull(i, j)) std::cout << " ";
                 else std::cout << "e";
             }
             std::cout << "\n";
@@ -88,54 +389,117 @@ public:
         std::cout << "\n";
     }
 
-    size_t getSiteCount() { return site_count; }
-    size_t getOpenSiteCount() { return open_sites_count; }
+    size_t getSiteCount() { return getElementCount(); }
+    size_t getOpenSiteCount() { return getOpenElementCount(); }
 
     std::tuple<size_t, size_t> getRandomBlockedSite() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        size_t i, j;
+        return getRandomBlockedSite(defaultRandomEngine());
+    }
 
-        do {
-            i = std::uniform_int_distribution<unsigned long long>{1, grid_size}(gen);
-            j = std::uniform_int_distribution<unsigned long long>{1, grid_size}(gen);
-        }
-        while(isOpen(i, j));
+    template <typename Engine>
+    std::tuple<size_t, size_t> getRandomBlockedSite(Engine& gen) {
+        size_t site = randomBlockedElement(gen);
+        return std::make_tuple(site / stride, site % stride);
+    }
 
-        return std::make_tuple(i, j);
+private:
+    bool validIndex(size_t i, size_t j) {
+        return i >= 1 && i <= grid_size && j >= 1 && j <= grid_size;
     }
 
-protected:
-    bool& getOpenSite(size_t i, size_t j) {
+    // Index of the site in the padded grid.
+    Index to1d(size_t i, size_t j) {
         assert(validIndex(i, j));
-        return open_sites[to1d(i, j)];
+        return (Index) (i * stride + j);
     }
 
-    std::vector<std::tuple<size_t, size_t> > neighbors(size_t i, size_t j) {
-        return {{i - 1, j}, {i, j - 1}, {i + 1, j}, {i + 1, j + 1}};
-    }
+    size_t grid_size;
+    size_t stride;
+};
 
-    bool validIndex(size_t i, size_t j) {
-        return i >= 1 && i <= grid_size && j >= 1 && j <= grid_size;
+/**
+ * Count, mean and variance of a stream of samples with Welford's algorithm, which does not lose precision to
+ * cancellation like summing squares does. Two partial results merge exactly (Chan et al.), so every thread
+ * can accumulate its own samples.
+ */
+class RunningStats {
+public:
+    void add(double x) {
+        count++;
+        double delta = x - _mean;
+        _mean += delta / count;
+        m2 += delta * (x - _mean);
     }
 
-    size_t to1d(size_t i, size_t j) {
-        assert(validIndex(i, j));
-        return (i - 1) * grid_size + j;
+    void merge(const RunningStats& other) {
+        if (other.count == 0) return;
+        auto total = count + other.count;
+        double delta = other._mean - _mean;
+        _mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        count = total;
     }
 
-    size_t topSite() { return 0; }
-    size_t bottomSite() { return site_count + 1; }
+    size_t size() const { return count; }
+    double mean() const { return _mean; }
+    // Sample variance, 0 for fewer than two samples.
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0; }
+    double standardDeviation() const { return std::sqrt(variance()); }
 
 private:
-    size_t site_count;
-    size_t grid_size;
-    WeightedQuickUnionUF uf;
-    WeightedQuickUnionUF uf_no_virtual_bottom;
-    std::deque<bool> open_sites;
-    size_t open_sites_count = 0;
+    size_t count = 0;
+    double _mean = 0;
+    double m2 = 0;
 };
 
+// Experiments of runPercolationTrials that share one random stream.
+const size_t percolation_trials_per_block = 8;
+
+inline size_t percolationBlockCount(size_t t) {
+    return (t + percolation_trials_per_block - 1) / percolation_trials_per_block;
+}
+
+inline size_t percolationWorkerCount(size_t t, ThreadPool& pool) {
+    return std::min(pool.size(), percolationBlockCount(t));
+}
+
+/**
+ * Runs t experiments on copies of prototype, any PercolationSystem, spread over the threads of pool, calling
+ * trial(p, gen, block, worker) for each of them with a reset system.
+ *
+ * Every worker reuses one copy, and every block of percolation_trials_per_block experiments draws from
+ * its own stream, a xoshiro256** engine seeded with seed and jumped once per block. The experiments of a block
+ * run in order on one worker, worker being in [0, percolationWorkerCount(t, pool)), so results accumulated per
+ * block, or in integers per worker, only depend on seed and not on the number of threads.
+ */
+template <typename System, typename Trial>
+void runPercolationTrials(const System& prototype, size_t t, ThreadPool& pool, uint64_t seed, Trial trial) {
+    auto blocks = percolationBlockCount(t);
+    std::vector<Xoshiro256StarStar> streams;
+    Xoshiro256StarStar gen(seed);
+    for (size_t b = 0; b < blocks; b++) {
+        streams.push_back(gen);
+        gen.jump();
+    }
+
+    std::atomic<size_t> next_block(0);
+    std::vector<std::future<void> > futures;
+    for (size_t w = 0; w < percolationWorkerCount(t, pool); w++) {
+        futures.push_back(pool.submit([&, t, w]() {
+            System p(prototype);
+            size_t b;
+            while ((b = next_block.fetch_add(1)) < blocks) {
+                auto end = std::min(t, (b + 1) * percolation_trials_per_block);
+                for (size_t i = b * percolation_trials_per_block; i < end; i++) {
+                    p.reset();
+                    trial(p, streams[b], b, w);
+                }
+            }
+        }));
+    }
+    waitAll(futures);
+}
+
 class PercolationStats {
 public:
     /**
@@ -144,44 +508,49 @@ public:
      * n - grid size.
      * t - number of independent experiments.
      */
-    PercolationStats(size_t n, size_t t) : results(t, 0) {
+    PercolationStats(size_t n, size_t t) {
         std::cout << "Compute percolation.\n";
+        Percolation p(n);
+        auto& gen = defaultRandomEngine();
         for (size_t i = 0; i < t; i++) {
-            Percolation p(n);
-            simulate(p, i);
-        }
-
-        for (size_t i = 0; i < t; i++) {
-            _mean += results[i];
-        }
-        _mean /= t;
-
-        for (size_t i = 0; i < t; i++) {
-            _standard_deviation += pow(results[i] - _mean, 2);
+            if (i > 0) p.reset();
+            stats.add(simulate(p, gen));
         }
-        _standard_deviation /= t - 1;
-
-        _confidence_low = _mean - (1.96 * _standard_deviation) / sqrt(t);
-        _confidence_high = _mean + (1.96 * _standard_deviation) / sqrt(t);
-
+        computeConfidence();
         printStats();
     }
 
-    void simulate(Percolation& p, size_t experiment_index) {
-        auto max_sites = p.getSiteCount();
-        while (p.getOpenSiteCount() < max_sites) {
-            size_t i, j;
-            std::tie(i, j) = p.getRandomBlockedSite();
-            p.open(i, j);
+    // Same experiments spread over the threads of pool with runPercolationTrials, the results only depend on seed.
+    PercolationStats(size_t n, size_t t, ThreadPool& pool, uint64_t seed) :
+            PercolationStats(Percolation(n), t, pool, seed) {}
+
+    // Experiments on copies of prototype, any PercolationSystem, e.g. bond percolation on a CubicLattice.
+    template <typename Lattice, typename Mode>
+    PercolationStats(const PercolationSystem<Lattice, Mode>& prototype, size_t t, ThreadPool& pool, uint64_t seed) {
+        std::vector<RunningStats> block_stats(percolationBlockCount(t));
+        runPercolationTrials(prototype, t, pool, seed, [&block_stats](PercolationSystem<Lattice, Mode>& p,
+                                                                      Xoshiro256StarStar& gen, size_t block, size_t) {
+            block_stats[block].add(simulate(p, gen));
+        });
+        for (auto& s : block_stats) stats.merge(s);
+        computeConfidence();
+    }
+
+    // Opens random blocked elements until the system percolates and returns the fraction of open elements.
+    template <typename System, typename Engine>
+    static double simulate(System& p, Engine& gen) {
+        auto max_elements = p.getElementCount();
+        while (p.getOpenElementCount() < max_elements) {
+            p.openRandomBlockedElement(gen);
             if (p.percolates()) {
                 break;
             }
         }
-        results[experiment_index] = (double) p.getOpenSiteCount() / max_sites;
+        return (double) p.getOpenElementCount() / max_elements;
     }
 
-    double mean() { return _mean; }
-    double standard_deviation() { return _standard_deviation; }
+    double mean() { return stats.mean(); }
+    double standard_deviation() { return stats.standardDeviation(); }
     double confidence_low() { return _confidence_low; }
     double confidence_high() { return _confidence_high; }
 
@@ -192,11 +561,232 @@ public:
     }
 
 private:
-    std::vector<double> results;
-    double _mean = 0;
-    double _standard_deviation = 0;
+    void computeConfidence() {
+        auto margin = 1.96 * stats.standardDeviation() / std::sqrt((double) stats.size());
+        _confidence_low = stats.mean() - margin;
+        _confidence_high = stats.mean() + margin;
+    }
+
+    RunningStats stats;
     double _confidence_low = 0;
     double _confidence_high = 0;
 };
 
+/**
+ * Newman-Ziff estimation of the whole percolation curve of a PercolationSystem from t experiments.
+ *
+ * Every experiment opens all N elements, sites or bonds, in random order, one sweep, and records after how many
+ * opened elements the system percolates and the size of the largest cluster after every opening. Averaging
+ * gives both quantities as functions of the number k of open elements (the microcanonical ensemble). A system
+ * whose elements are each open with probability p has k open ones with probability binomial(N, k, p), so the
+ * curves for any p are the averages weighted by those probabilities, without running experiments for each p.
+ *
+ * A system may never percolate, e.g. a GraphLattice whose top and bottom vertices are not connected. Such
+ * experiments count as not percolated for every k and are left out of the threshold moments.
+ *
+ * The totals are integer counts, so that their sums do not depend on which thread ran which experiment.
+ */
+class PercolationCurve {
+public:
+    // The curve of an nxn grid.
+    PercolationCurve(size_t n, size_t t, ThreadPool& pool, uint64_t seed) :
+            PercolationCurve(Percolation(n), t, pool, seed) {}
+
+    template <typename Lattice, typename Mode>
+    PercolationCurve(const PercolationSystem<Lattice, Mode>& prototype, size_t t, ThreadPool& pool, uint64_t seed) :
+            element_count(prototype.getElementCount()), trials(t) {
+        auto workers = percolationWorkerCount(t, pool);
+        // The last count is of the experiments that never percolated.
+        std::vector<std::vector<uint64_t> > threshold_counts(workers, std::vector<uint64_t>(element_count + 2));
+        std::vector<std::vector<uint64_t> > largest_sums(workers, std::vector<uint64_t>(element_count + 1));
+        runPercolationTrials(prototype, t, pool, seed, [&](PercolationSystem<Lattice, Mode>& p,
+                                                           Xoshiro256StarStar& gen, size_t, size_t w) {
+            sweep(p, gen, threshold_counts[w], largest_sums[w]);
+        });
+
+        auto site_count = (double) prototype.lattice().siteCount();
+        percolated_after.assign(element_count + 1, 0);
+        largest_cluster_after.assign(element_count + 1, 0);
+        for (size_t k = 0; k <= element_count; k++) {
+            uint64_t thresholds = 0, largest = 0;
+            for (size_t w = 0; w < workers; w++) {
+                thresholds += threshold_counts[w][k];
+                largest += largest_sums[w][k];
+            }
+            threshold_mean += (double) k * thresholds;
+            threshold_square_mean += (double) k * k * thresholds;
+            percolated_after[k] = (k > 0 ? percolated_after[k - 1] : 0) + (double) thresholds / t;
+            largest_cluster_after[k] = largest / (t * site_count);
+            percolating_trials += thresholds;
+        }
+        if (element_count > 0 && percolating_trials > 0) {
+            threshold_mean /= (double) percolating_trials * element_count;
+            threshold_square_mean /= (double) percolating_trials * element_count * element_count;
+        }
+    }
+
+    // Opens every element of p in random order. Counts the number of open elements at which p starts to
+    // percolate in threshold_counts, N + 1 if it never does, and adds the size of the largest cluster after each
+    // opening to largest_sums.
+    template <typename System, typename Engine>
+    static void sweep(System& p, Engine& gen, std::vector<uint64_t>& threshold_counts,
+                      std::vector<uint64_t>& largest_sums) {
+        auto max_elements = p.getElementCount();
+        auto never = max_elements + 1;
+        size_t threshold = p.percolates() ? 0 : never;
+        largest_sums[0] += p.getLargestClusterSize();
+        for (size_t k = 1; k <= max_elements; k++) {
+            p.openRandomBlockedElement(gen);
+            if (threshold == never && p.percolates()) threshold = k;
+            largest_sums[k] += p.getLargestClusterSize();
+        }
+        threshold_counts[threshold]++;
+    }
+
+    // Mean and standard deviation of the fraction of open elements at which the experiments that percolated
+    // did, the estimate of PercolationStats.
+    double thresholdMean() { return threshold_mean; }
+    double thresholdStandardDeviation() {
+        if (percolating_trials < 2) return 0;
+        auto variance = (threshold_square_mean - threshold_mean * threshold_mean) * percolating_trials
+                        / (percolating_trials - 1);
+        return std::sqrt(std::max(variance, 0.0));
+    }
+
+    // Number of experiments that percolated at some point of their sweep.
+    size_t percolatingTrials() { return percolating_trials; }
+
+    // Fraction of the experiments that percolated with k open elements, k <= N.
+    double percolatedAfter(size_t k) { return percolated_after[k]; }
+    // Mean fraction of the sites in the largest cluster with k open elements.
+    double largestClusterAfter(size_t k) { return largest_cluster_after[k]; }
+
+    // Probability that the system percolates when every element is open with probability p.
+    double percolationProbability(double p) { return binomialAverage(percolated_after, p); }
+    // Mean fraction of the sites in the largest cluster when every element is open with probability p.
+    double largestClusterFraction(double p) { return binomialAverage(largest_cluster_after, p); }
+
+    // Average of values[k] weighted by binomial(N, k, p), N + 1 being the size of values. The weights are
+    // computed relative to the most likely k, walking away from it until they become negligible, which avoids
+    // the underflow of the terms p^k (1 - p)^(N - k) for large N.
+    static double binomialAverage(const std::vector<double>& values, double p) {
+        auto n = values.size() - 1;
+        if (p <= 0) return values[0];
+        if (p >= 1) return values[n];
+        auto mode = std::min(n, (size_t) ((n + 1) * p));
+        auto odds = p / (1 - p);
+        double total = values[mode], weights = 1, weight = 1;
+        for (auto k = mode; k < n && weight > 1e-17; k++) {
+            weight *= (double) (n - k) / (k + 1) * odds;
+            total += weight * values[k + 1];
+            weights += weight;
+        }
+        weight = 1;
+        for (auto k = mode; k > 0 && weight > 1e-17; k--) {
+            weight *= (double) k / (n - k + 1) / odds;
+            total += weight * values[k - 1];
+            weights += weight;
+        }
+        return total / weights;
+    }
+
+private:
+    size_t element_count;
+    size_t trials;
+    size_t percolating_trials = 0;
+    double threshold_mean = 0;
+    double threshold_square_mean = 0;
+    std::vector<double> percolated_after;
+    std::vector<double> largest_cluster_after;
+};
+
+void testPercolation() {
+    std::cout << "Test percolation.\n";
+    Percolation small(3);
+    small.open(1, 2);
+    small.open(2, 2);
+    small.open(3, 1);
+    std::cout << "Percolates: " << small.percolates() << ", ";
+    small.open(3, 2);
+    std::cout << "after opening (3, 2): " << small.percolates() << ", (3, 1) full: " << small.isFull(3, 1) << "\n";
+    small.print();
+
+    PercolationStats(50, 100);
+
+    bool rejected = false;
+    try {
+        CubicLattice too_large(2000);
+    }
+    catch (const std::length_error&) {
+        rejected = true;
+    }
+    std::cout << "A cubic lattice of side 2000 is rejected: " << rejected << "\n";
+
+    std::cout << "Compute percolation on a thread pool.\n";
+    ThreadPool one(1), four(4);
+    PercolationStats sequential(50, 100, one, 42);
+    PercolationStats parallel(50, 100, four, 42);
+    parallel.printStats();
+    std::cout << "Same results on 1 and 4 threads: "
+              << (sequential.mean() == parallel.mean() &&
+                  sequential.standard_deviation() == parallel.standard_deviation()) << "\n";
+
+    std::cout << "Compute the percolation curve in one sweep per experiment.\n";
+    PercolationCurve curve(50, 100, four, 42), curve_sequential(50, 100, one, 42);
+    std::cout << "Threshold mean: " << curve.thresholdMean() << ", standard deviation: "
+              << curve.thresholdStandardDeviation() << "\n";
+    for (auto p : {0.5, 0.55, 0.59, 0.6, 0.65}) {
+        std::cout << "p = " << p << ": percolates " << curve.percolationProbability(p) << ", largest cluster "
+                  << curve.largestClusterFraction(p) << "\n";
+    }
+    std::cout << "Same curve on 1 and 4 threads: "
+              << (curve.percolationProbability(0.59) == curve_sequential.percolationProbability(0.59) &&
+                  curve.largestClusterFraction(0.59) == curve_sequential.largestClusterFraction(0.59)) << "\n";
+
+    std::cout << "Percolation thresholds of other lattices and modes.\n";
+    PercolationStats square_bonds(PercolationSystem<SquareLattice, BondPercolation>(SquareLattice(50)), 100, four, 42);
+    PercolationStats cubic_sites(PercolationSystem<CubicLattice>(CubicLattice(20)), 100, four, 42);
+    PercolationStats cubic_bonds(PercolationSystem<CubicLattice, BondPercolation>(CubicLattice(20)), 100, four, 42);
+    std::cout << "Square bonds: " << square_bonds.mean() << ", cubic sites: " << cubic_sites.mean()
+              << ", cubic bonds: " << cubic_bonds.mean() << "\n";
+
+    // The same grid as a Graph, with its vertices in the order of the lattice sites.
+    const int side = 50;
+    Graph grid(side * side);
+    std::vector<int> top, bottom;
+    for (int i = 0; i < side; i++) {
+        for (int j = 0; j < side; j++) {
+            if (j + 1 < side) grid.addEdge(i * side + j, i * side + j + 1);
+            if (i + 1 < side) grid.addEdge(i * side + j, (i + 1) * side + j);
+        }
+        top.push_back(i);
+        bottom.push_back((side - 1) * side + i);
+    }
+    PercolationStats graph_sites(PercolationSystem<GraphLattice>(GraphLattice(grid, top, bottom)), 100, four, 42);
+    PercolationStats graph_bonds(PercolationSystem<GraphLattice, BondPercolation>(GraphLattice(grid, top, bottom)),
+                                 100, four, 42);
+    std::cout << "Grid graph sites match the square lattice: " << (graph_sites.mean() == parallel.mean())
+              << ", grid graph bonds: " << graph_bonds.mean() << "\n";
+
+    // Two paths, the top one never reaches the bottom one.
+    Graph paths(6);
+    paths.addEdge(0, 1);
+    paths.addEdge(1, 2);
+    paths.addEdge(3, 4);
+    paths.addEdge(4, 5);
+    PercolationCurve disconnected(PercolationSystem<GraphLattice>(GraphLattice(paths, {0}, {5})), 20, four, 42);
+    std::cout << "Disconnected graph: " << disconnected.percolatingTrials() << " of 20 experiments percolate, "
+              << "percolated after opening every site: " << disconnected.percolatedAfter(6)
+              << ", grid: " << curve.percolatingTrials() << " of 100\n";
+
+    RunningStats all, left, right;
+    for (int i = 1; i <= 10; i++) {
+        all.add(i);
+        (i <= 3 ? left : right).add(i);
+    }
+    left.merge(right);
+    std::cout << "Merged running stats: " << left.mean() << " " << left.variance() << ", all at once: "
+              << all.mean() << " " << all.variance() << "\n";
+}
+
 #endif //ALGS_PERCOLATION_H
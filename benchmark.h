@@ -6,6 +6,21 @@
 #define ALGS_BENCHMARK_H
 
 #include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <memory>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ALGS_HAVE_RDTSC 1
+#endif
 
 template<typename TimeT = std::chrono::milliseconds>
 struct measure
@@ -13,12 +28,444 @@ struct measure
     template<typename F, typename ...Args>
     static typename TimeT::rep execution(F func, Args&&... args)
     {
-        auto start = std::chrono::system_clock::now();
+        // steady_clock is monotonic, system_clock can jump backwards (NTP, manual changes).
+        auto start = std::chrono::steady_clock::now();
         func(std::forward<Args>(args)...);
         auto duration = std::chrono::duration_cast< TimeT>
-                (std::chrono::system_clock::now() - start);
+                (std::chrono::steady_clock::now() - start);
         return duration.count();
     }
 };
 
+// Forces the compiler to materialize value, so that a computation whose result is otherwise unused is not
+// optimized away.
+template <typename T>
+inline void doNotOptimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Forces all pending memory writes to be considered observable.
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+struct SteadyClock {
+    static const char* unit() { return "ns"; }
+
+    static uint64_t now() {
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+#ifdef ALGS_HAVE_RDTSC
+struct TscClock {
+    static const char* unit() { return "cycles"; }
+
+    static uint64_t now() {
+        // The fence keeps rdtsc from being executed before preceding instructions retire.
+        _mm_lfence();
+        uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+    }
+};
+#endif
+
+/**
+ * Heap allocation counters. They are only maintained by programs that replace the global operator new to call
+ * record(), like algs_bench does, otherwise they stay at zero.
+ */
+struct AllocationCounter {
+    static std::atomic<unsigned long long>& bytes() {
+        static std::atomic<unsigned long long> value(0);
+        return value;
+    }
+
+    static std::atomic<unsigned long long>& count() {
+        static std::atomic<unsigned long long> value(0);
+        return value;
+    }
+
+    static void record(size_t size) {
+        bytes().fetch_add(size, std::memory_order_relaxed);
+        count().fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+struct BenchmarkStats {
+    size_t samples = 0;
+    double min = 0;
+    double max = 0;
+    double mean = 0;
+    double stddev = 0;
+    double median = 0;
+    double p95 = 0;
+    double p99 = 0;
+    // Median absolute deviation, a robust alternative to stddev that ignores outliers caused by preemption.
+    double mad = 0;
+
+    // Linear interpolation between the two closest ranks, sorted must be non-empty and sorted.
+    static double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.size() == 1) return sorted[0];
+        double rank = p * (sorted.size() - 1);
+        size_t lo = (size_t) std::floor(rank);
+        size_t hi = std::min(lo + 1, sorted.size() - 1);
+        return sorted[lo] + (rank - lo) * (sorted[hi] - sorted[lo]);
+    }
+
+    static BenchmarkStats fromSamples(std::vector<double> values) {
+        BenchmarkStats stats;
+        stats.samples = values.size();
+        if (values.empty()) return stats;
+
+        std::sort(values.begin(), values.end());
+        stats.min = values.front();
+        stats.max = values.back();
+        stats.median = percentile(values, 0.5);
+        stats.p95 = percentile(values, 0.95);
+        stats.p99 = percentile(values, 0.99);
+
+        for (auto v : values) stats.mean += v;
+        stats.mean /= values.size();
+        if (values.size() > 1) {
+            for (auto v : values) stats.stddev += (v - stats.mean) * (v - stats.mean);
+            stats.stddev = std::sqrt(stats.stddev / (values.size() - 1));
+        }
+
+        std::vector<double> deviations;
+        deviations.reserve(values.size());
+        for (auto v : values) deviations.push_back(std::fabs(v - stats.median));
+        std::sort(deviations.begin(), deviations.end());
+        stats.mad = percentile(deviations, 0.5);
+        return stats;
+    }
+};
+
+/**
+ * Distribution of the latencies of single operations. Values below 32 have a bucket each, and every power of two
+ * above is split into 32 buckets, so a bucket is at most 1/32 of its values wide and millions of latencies take
+ * 15 KB, while the tail percentiles stay accurate.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram() : buckets((64 - sub_bucket_bits + 1) * sub_bucket_count) {}
+
+    void record(uint64_t value) {
+        buckets[bucketOf(value)]++;
+        total++;
+        largest = std::max(largest, value);
+    }
+
+    void clear() {
+        std::fill(buckets.begin(), buckets.end(), 0);
+        total = 0;
+        largest = 0;
+    }
+
+    unsigned long long count() const { return total; }
+    uint64_t max() const { return largest; }
+
+    // Upper bound of the bucket of the value of rank p * count(), p in [0, 1].
+    double percentile(double p) const {
+        if (total == 0) return 0;
+        auto rank = (unsigned long long) std::ceil(p * total);
+        unsigned long long seen = 0;
+        for (size_t b = 0; b < buckets.size(); b++) {
+            seen += buckets[b];
+            if (seen >= std::max(rank, 1ULL)) return (double) std::min(bucketUpperBound(b), largest);
+        }
+        return (double) largest;
+    }
+
+private:
+    static const int sub_bucket_bits = 5;
+    static const uint64_t sub_bucket_count = 1 << sub_bucket_bits;
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < sub_bucket_count) return (size_t) value;
+        int top = 63 - __builtin_clzll(value);
+        return (size_t) ((top - sub_bucket_bits + 1) * sub_bucket_count
+                         + ((value >> (top - sub_bucket_bits)) & (sub_bucket_count - 1)));
+    }
+
+    static uint64_t bucketUpperBound(size_t bucket) {
+        if (bucket < sub_bucket_count) return bucket;
+        int shift = (int) (bucket / sub_bucket_count) - 1;
+        uint64_t lower = (sub_bucket_count + bucket % sub_bucket_count) << shift;
+        return lower + (((uint64_t) 1 << shift) - 1);
+    }
+
+    std::vector<unsigned long long> buckets;
+    unsigned long long total = 0;
+    uint64_t largest = 0;
+};
+
+// Times single operations of a benchmark run with the clock of the runner.
+class LatencyRecorder {
+public:
+    template <typename F>
+    void time(F f) {
+        auto start = now();
+        f();
+        histogram.record(now() - start);
+    }
+
+    uint64_t (*now)() = SteadyClock::now;
+    LatencyHistogram histogram;
+};
+
+struct Benchmark {
+    std::string name;
+    // Timed body of the benchmark.
+    std::function<void()> run;
+    // Untimed preparation executed before every warmup and sample run, e.g. restoring an unsorted input.
+    std::function<void()> setup;
+    // Untimed cleanup executed once after the last sample run, e.g. freeing the data that setup made.
+    std::function<void()> teardown;
+    // Number of items processed by one run, used to report per-item cost. 0 if not meaningful.
+    unsigned long items;
+    // Latencies of the single operations of the sample runs, for benchmarks registered with
+    // registerLatencyBenchmark.
+    std::shared_ptr<LatencyRecorder> recorder;
+};
+
+class BenchmarkRegistry {
+public:
+    static BenchmarkRegistry& instance() {
+        static BenchmarkRegistry registry;
+        return registry;
+    }
+
+    void add(const Benchmark& benchmark) {
+        benchmarks.push_back(benchmark);
+    }
+
+    const std::vector<Benchmark>& all() const { return benchmarks; }
+
+    // Benchmarks whose name contains filter as a sub-string. An empty filter matches everything.
+    std::vector<Benchmark> matching(const std::string& filter) const {
+        std::vector<Benchmark> result;
+        for (auto& b : benchmarks) {
+            if (filter.empty() || b.name.find(filter) != std::string::npos) {
+                result.push_back(b);
+            }
+        }
+        return result;
+    }
+
+private:
+    BenchmarkRegistry() {}
+    std::vector<Benchmark> benchmarks;
+};
+
+inline void registerBenchmark(const std::string& name, std::function<void()> run,
+                              std::function<void()> setup = nullptr, unsigned long items = 0,
+                              std::function<void()> teardown = nullptr) {
+    Benchmark b;
+    b.name = name;
+    b.run = run;
+    b.setup = setup;
+    b.teardown = teardown;
+    b.items = items;
+    BenchmarkRegistry::instance().add(b);
+}
+
+// A benchmark that also times single operations, by wrapping them in recorder.time(), for their percentiles.
+inline void registerLatencyBenchmark(const std::string& name, std::function<void(LatencyRecorder&)> run,
+                                     std::function<void()> setup = nullptr, unsigned long items = 0,
+                                     std::function<void()> teardown = nullptr) {
+    auto recorder = std::make_shared<LatencyRecorder>();
+    Benchmark b;
+    b.name = name;
+    b.run = [run, recorder]() { run(*recorder); };
+    b.setup = setup;
+    b.teardown = teardown;
+    b.items = items;
+    b.recorder = recorder;
+    BenchmarkRegistry::instance().add(b);
+}
+
+struct BenchmarkResult {
+    std::string name;
+    std::string unit;
+    unsigned long items;
+    BenchmarkStats stats;
+    // Heap allocations made by a single timed run.
+    unsigned long long allocated_bytes;
+    unsigned long long allocations;
+    // Single operation latencies of all the samples, empty unless the benchmark records them.
+    LatencyHistogram latencies;
+};
+
+struct BenchmarkOptions {
+    size_t warmup = 2;
+    size_t samples = 11;
+    bool use_tsc = false;
+};
+
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(BenchmarkOptions _options) : options(_options) {}
+
+    BenchmarkResult run(const Benchmark& benchmark) {
+#ifdef ALGS_HAVE_RDTSC
+        if (options.use_tsc) return runWithClock<TscClock>(benchmark);
+#endif
+        return runWithClock<SteadyClock>(benchmark);
+    }
+
+    std::vector<BenchmarkResult> run(const std::vector<Benchmark>& benchmarks, std::ostream* progress = nullptr) {
+        std::vector<BenchmarkResult> results;
+        for (auto& b : benchmarks) {
+            if (progress) *progress << "Running " << b.name << "...\n";
+            results.push_back(run(b));
+        }
+        return results;
+    }
+
+protected:
+    template <typename Clock>
+    BenchmarkResult runWithClock(const Benchmark& benchmark) {
+        if (benchmark.recorder) benchmark.recorder->now = Clock::now;
+        for (size_t i = 0; i < options.warmup; i++) {
+            if (benchmark.setup) benchmark.setup();
+            benchmark.run();
+        }
+        if (benchmark.recorder) benchmark.recorder->histogram.clear();
+
+        std::vector<double> samples;
+        samples.reserve(options.samples);
+        unsigned long long allocated_bytes = 0, allocations = 0;
+        for (size_t i = 0; i < options.samples; i++) {
+            if (benchmark.setup) benchmark.setup();
+            auto bytes_before = AllocationCounter::bytes().load();
+            auto count_before = AllocationCounter::count().load();
+            clobberMemory();
+            auto start = Clock::now();
+            benchmark.run();
+            clobberMemory();
+            auto end = Clock::now();
+            samples.push_back((double) (end - start));
+            allocated_bytes = AllocationCounter::bytes().load() - bytes_before;
+            allocations = AllocationCounter::count().load() - count_before;
+        }
+        if (benchmark.teardown) benchmark.teardown();
+
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        result.unit = Clock::unit();
+        result.items = benchmark.items;
+        result.stats = BenchmarkStats::fromSamples(samples);
+        result.allocated_bytes = allocated_bytes;
+        result.allocations = allocations;
+        if (benchmark.recorder) result.latencies = benchmark.recorder->histogram;
+        return result;
+    }
+
+private:
+    BenchmarkOptions options;
+};
+
+inline std::string jsonEscape(const std::string& s) {
+    std::string escaped;
+    for (auto c : s) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeBenchmarkResultsTable(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    os << std::left << std::setw(56) << "name" << std::right
+       << std::setw(8) << "unit"
+       << std::setw(14) << "median"
+       << std::setw(14) << "p95"
+       << std::setw(14) << "p99"
+       << std::setw(12) << "mad"
+       << std::setw(14) << "min"
+       << std::setw(12) << "per item"
+       << std::setw(14) << "alloc bytes" << "\n";
+    for (auto& r : results) {
+        os << std::left << std::setw(56) << r.name << std::right << std::fixed << std::setprecision(0)
+           << std::setw(8) << r.unit
+           << std::setw(14) << r.stats.median
+           << std::setw(14) << r.stats.p95
+           << std::setw(14) << r.stats.p99
+           << std::setw(12) << r.stats.mad
+           << std::setw(14) << r.stats.min
+           << std::setprecision(2) << std::setw(12) << (r.items ? r.stats.median / r.items : 0.0)
+           << std::setw(14) << r.allocated_bytes << "\n";
+    }
+
+    bool any_latencies = false;
+    for (auto& r : results) any_latencies |= r.latencies.count() > 0;
+    if (any_latencies) {
+        os << "\n" << std::left << std::setw(56) << "single operation latency" << std::right
+           << std::setw(8) << "unit"
+           << std::setw(14) << "operations"
+           << std::setw(12) << "p50"
+           << std::setw(12) << "p99"
+           << std::setw(12) << "p99.9"
+           << std::setw(12) << "p99.99"
+           << std::setw(14) << "max" << "\n";
+        for (auto& r : results) {
+            auto& l = r.latencies;
+            if (l.count() == 0) continue;
+            os << std::left << std::setw(56) << r.name << std::right << std::fixed << std::setprecision(0)
+               << std::setw(8) << r.unit
+               << std::setw(14) << l.count()
+               << std::setw(12) << l.percentile(0.5)
+               << std::setw(12) << l.percentile(0.99)
+               << std::setw(12) << l.percentile(0.999)
+               << std::setw(12) << l.percentile(0.9999)
+               << std::setw(14) << (double) l.max() << "\n";
+        }
+    }
+    os.unsetf(std::ios_base::floatfield);
+}
+
+void writeBenchmarkResultsCsv(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    auto precision = os.precision(15);
+    os << "name,unit,items,samples,min,max,mean,stddev,median,p95,p99,mad,allocated_bytes,allocations,"
+       << "latency_count,latency_p50,latency_p99,latency_p999,latency_p9999,latency_max\n";
+    for (auto& r : results) {
+        auto& s = r.stats;
+        auto& l = r.latencies;
+        os << r.name << "," << r.unit << "," << r.items << "," << s.samples << ","
+           << s.min << "," << s.max << "," << s.mean << "," << s.stddev << ","
+           << s.median << "," << s.p95 << "," << s.p99 << "," << s.mad << ","
+           << r.allocated_bytes << "," << r.allocations << "," << l.count() << ","
+           << l.percentile(0.5) << "," << l.percentile(0.99) << "," << l.percentile(0.999) << ","
+           << l.percentile(0.9999) << "," << l.max() << "\n";
+    }
+    os.precision(precision);
+}
+
+void writeBenchmarkResultsJson(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    auto precision = os.precision(15);
+    os << "{\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        auto& r = results[i];
+        auto& s = r.stats;
+        os << (i ? ",\n" : "\n")
+           << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"unit\": \"" << r.unit << "\""
+           << ", \"items\": " << r.items << ", \"samples\": " << s.samples
+           << ", \"min\": " << s.min << ", \"max\": " << s.max
+           << ", \"mean\": " << s.mean << ", \"stddev\": " << s.stddev
+           << ", \"median\": " << s.median << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99
+           << ", \"mad\": " << s.mad
+           << ", \"allocated_bytes\": " << r.allocated_bytes << ", \"allocations\": " << r.allocations;
+        auto& l = r.latencies;
+        if (l.count() > 0) {
+            os << ", \"latency\": {\"count\": " << l.count() << ", \"p50\": " << l.percentile(0.5)
+               << ", \"p99\": " << l.percentile(0.99) << ", \"p999\": " << l.percentile(0.999)
+               << ", \"p9999\": " << l.percentile(0.9999) << ", \"max\": " << l.max() << "}";
+        }
+        os << "}";
+    }
+    os << "\n  ]\n}\n";
+    os.precision(precision);
+}
+
 #endif //ALGS_BENCHMARK_H
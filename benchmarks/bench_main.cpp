@@ -0,0 +1,133 @@
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include "../unionfind.h"
+#include "../stack.h"
+#include "../queue.h"
+#include "../sorts.h"
+#include "../priority_queue.h"
+#include "../bst.h"
+#include "../llrb.h"
+#include "../hash_table.h"
+#include "../graph.h"
+#include "../digraph.h"
+#include "sorts_bench.h"
+#include "unionfind_bench.h"
+#include "hash_table_bench.h"
+#include "llrb_bench.h"
+#include "graph_bench.h"
+#include "parallel_sorts_bench.h"
+#include "pdq_sort_bench.h"
+#include "radix_sort_bench.h"
+#include "sorting_networks_bench.h"
+#include "external_sort_bench.h"
+#include "shuffle_bench.h"
+#include "dynamic_connectivity_bench.h"
+#include "mapped_file_bench.h"
+#include "percolation_bench.h"
+#include "successor_set_bench.h"
+#include "hash_bench.h"
+
+// Global allocation hooks feeding AllocationCounter, so that every benchmark reports the bytes it allocates.
+void* operator new(std::size_t size) {
+    AllocationCounter::record(size);
+    void* p = std::malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --list                  List registered benchmarks and exit.\n"
+              << "  --filter=<substring>    Only run benchmarks whose name contains substring.\n"
+              << "  --format=table|json|csv Output format, table by default.\n"
+              << "  --output=<file>         Write results to file instead of stdout.\n"
+              << "  --warmup=<n>            Untimed runs before sampling.\n"
+              << "  --samples=<n>           Timed runs per benchmark.\n"
+              << "  --clock=steady|tsc      Timing source, steady_clock (ns) or rdtsc (cycles).\n";
+}
+
+bool parseOption(const char* arg, const char* name, std::string& value) {
+    auto length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') return false;
+    value = arg + length + 1;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    std::string filter, format = "table", output, value;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        if      (strcmp(argv[i], "--list") == 0) list = true;
+        else if (parseOption(argv[i], "--filter", value)) filter = value;
+        else if (parseOption(argv[i], "--format", value)) format = value;
+        else if (parseOption(argv[i], "--output", value)) output = value;
+        else if (parseOption(argv[i], "--warmup", value)) options.warmup = std::stoul(value);
+        else if (parseOption(argv[i], "--samples", value)) options.samples = std::stoul(value);
+        else if (parseOption(argv[i], "--clock", value)) options.use_tsc = value == "tsc";
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (format != "table" && format != "json" && format != "csv") {
+        printUsage(argv[0]);
+        return 1;
+    }
+#ifndef ALGS_HAVE_RDTSC
+    if (options.use_tsc) {
+        std::cerr << "rdtsc is not available on this platform, using steady_clock.\n";
+    }
+#endif
+
+    registerSortBenchmarks();
+    registerUnionFindBenchmarks();
+    registerHashTableBenchmarks();
+    registerLLRBBenchmarks();
+    registerGraphBenchmarks();
+    registerParallelSortBenchmarks();
+    registerPdqSortBenchmarks();
+    registerRadixSortBenchmarks();
+    registerSortingNetworkBenchmarks();
+    registerExternalSortBenchmarks();
+    registerShuffleBenchmarks();
+    registerDynamicConnectivityBenchmarks();
+    registerMappedFileBenchmarks();
+    registerPercolationBenchmarks();
+    registerSuccessorSetBenchmarks();
+    registerHashBenchmarks();
+
+    auto benchmarks = BenchmarkRegistry::instance().matching(filter);
+    if (list) {
+        for (auto& b : benchmarks) std::cout << b.name << "\n";
+        return 0;
+    }
+
+    BenchmarkRunner runner(options);
+    auto results = runner.run(benchmarks, &std::cerr);
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file) {
+            std::cerr << "Error opening file.\n";
+            return 1;
+        }
+    }
+    std::ostream& os = output.empty() ? std::cout : file;
+    if      (format == "json") writeBenchmarkResultsJson(os, results);
+    else if (format == "csv")  writeBenchmarkResultsCsv(os, results);
+    else                       writeBenchmarkResultsTable(os, results);
+    return 0;
+}
@@ -0,0 +1,144 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_BENCH_UTILS_H
+#define ALGS_BENCH_UTILS_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include <utility>
+#include <functional>
+#include "../benchmark.h"
+#include "../fast_random.h"
+
+// All generators are seeded deterministically, so that consecutive benchmark runs sort and insert the same data.
+const unsigned long bench_seed = 42;
+
+std::vector<int> randomInts(size_t n, unsigned long seed = bench_seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<int> dist;
+    std::vector<int> values(n);
+    for (auto& v : values) v = dist(gen);
+    return values;
+}
+
+// Inputs that are known to hurt quick sort pivot selection, next to plain random data.
+std::vector<std::string> intPatterns() {
+    return {"random", "sorted", "reversed", "organ_pipe", "few_unique"};
+}
+
+std::vector<int> patternedInts(const std::string& pattern, size_t n, unsigned long seed = bench_seed) {
+    std::vector<int> values = randomInts(n, seed);
+    if (pattern == "sorted") {
+        std::sort(values.begin(), values.end());
+    }
+    else if (pattern == "reversed") {
+        std::sort(values.begin(), values.end(), std::greater<int>());
+    }
+    else if (pattern == "organ_pipe") {
+        for (size_t i = 0; i < n; i++) values[i] = (int) std::min(i, n - i);
+    }
+    else if (pattern == "few_unique") {
+        for (auto& v : values) v &= 15;
+    }
+    return values;
+}
+
+std::vector<double> randomDoubles(size_t n, unsigned long seed = bench_seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> dist(-1e9, 1e9);
+    std::vector<double> values(n);
+    for (auto& v : values) v = dist(gen);
+    return values;
+}
+
+std::vector<std::string> randomStrings(size_t n, size_t max_length = 16, unsigned long seed = bench_seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<size_t> length(1, max_length);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::vector<std::string> values(n);
+    for (auto& v : values) {
+        v.resize(length(gen));
+        for (auto& c : v) c = (char) letter(gen);
+    }
+    return values;
+}
+
+std::vector<std::pair<unsigned long, unsigned long> > randomPairs(unsigned long n, size_t m, unsigned long seed = bench_seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<unsigned long> dist(0, n - 1);
+    std::vector<std::pair<unsigned long, unsigned long> > pairs(m);
+    for (auto& p : pairs) p = std::make_pair(dist(gen), dist(gen));
+    return pairs;
+}
+
+// Registers a benchmark that sorts a fresh copy of input on every run. The copy is made in the untimed setup.
+template <typename T>
+void registerSortBenchmark(const std::string& name, const std::vector<T>& input,
+                           std::function<void(std::vector<T>&)> sort) {
+    auto master = std::make_shared<std::vector<T> >(input);
+    auto work = std::make_shared<std::vector<T> >();
+    registerBenchmark(name, [work, sort]() {
+        sort(*work);
+        doNotOptimize(work->data());
+    }, [master, work]() {
+        *work = *master;
+        // Sorts that shuffle first get the same shuffle on every run.
+        seedDefaultRandomEngine(bench_seed);
+    }, input.size());
+}
+
+// Input of sort benchmarks made by the first one that runs, so that listing or filtering them out allocates
+// nothing. The benchmarks registered with it also share the copy they sort, as they run one at a time.
+template <typename T>
+struct SharedSortInput {
+    std::function<std::vector<T>()> generate;
+    size_t size;
+    std::vector<T> master;
+    std::vector<T> work;
+
+    SharedSortInput(size_t n, std::function<std::vector<T>()> _generate) : generate(_generate), size(n) {}
+
+    void reset() {
+        if (master.empty()) master = generate();
+        work = master;
+    }
+};
+
+// Like registerSortBenchmark above, prepare runs in the untimed setup, e.g. to start a thread pool.
+template <typename T>
+void registerSortBenchmark(const std::string& name, std::shared_ptr<SharedSortInput<T> > input,
+                           std::function<void(std::vector<T>&)> sort, std::function<void()> prepare = nullptr) {
+    registerBenchmark(name, [input, sort]() {
+        sort(input->work);
+        doNotOptimize(input->work.data());
+    }, [input, prepare]() {
+        if (prepare) prepare();
+        input->reset();
+        seedDefaultRandomEngine(bench_seed);
+    }, input->size);
+}
+
+// Data of benchmarks made by the setup of the first one that runs, so that listing or filtering them out
+// allocates nothing. Their teardown releases it, the next benchmark that needs it makes it again.
+template <typename T>
+class LazyBenchmarkData {
+public:
+    explicit LazyBenchmarkData(std::function<T()> _generate) : generate(_generate) {}
+
+    T& get() {
+        if (!data) data.reset(new T(generate()));
+        return *data;
+    }
+
+    void release() { data.reset(); }
+
+private:
+    std::function<T()> generate;
+    std::unique_ptr<T> data;
+};
+
+#endif //ALGS_BENCH_UTILS_H
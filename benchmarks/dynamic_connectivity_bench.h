@@ -0,0 +1,91 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_DYNAMIC_CONNECTIVITY_BENCH_H
+#define ALGS_DYNAMIC_CONNECTIVITY_BENCH_H
+
+#include "bench_utils.h"
+#include "../unionfind.h"
+#include "../applications/dynamic_connectivity.h"
+
+// One event of a dynamic connectivity stream: kind 0 inserts edge (a, b), 1 deletes it, 2 queries it.
+struct ConnectivityEvent {
+    int kind;
+    unsigned long a;
+    unsigned long b;
+};
+
+typedef std::vector<ConnectivityEvent> ConnectivityEvents;
+
+// Equal parts of insertions, deletions of a random present edge and queries of random pairs.
+ConnectivityEvents randomConnectivityEvents(unsigned long n, size_t m) {
+    std::mt19937_64 gen(bench_seed);
+    std::uniform_int_distribution<unsigned long> vertex(0, n - 1);
+    ConnectivityEvents events;
+    std::vector<std::pair<unsigned long, unsigned long> > present;
+    for (size_t i = 0; i < m; i++) {
+        int kind = (int) (gen() % 3);
+        if (kind == 1 && !present.empty()) {
+            auto k = gen() % present.size();
+            events.push_back({1, present[k].first, present[k].second});
+            present[k] = present.back();
+            present.pop_back();
+        }
+        else if (kind == 2) {
+            events.push_back({2, vertex(gen), vertex(gen)});
+        }
+        else {
+            events.push_back({0, vertex(gen), vertex(gen)});
+            present.push_back(std::make_pair(events.back().a, events.back().b));
+        }
+    }
+    return events;
+}
+
+void registerDynamicConnectivityBenchmarks() {
+    // Rebuilding a union-find from the present edges at every query is quadratic, so it only gets the small
+    // stream.
+    const unsigned long small_n = 1000;
+    const unsigned long n = 100000;
+    auto small_events = std::make_shared<ConnectivityEvents>(randomConnectivityEvents(small_n, 30000));
+    auto events = std::make_shared<ConnectivityEvents>(randomConnectivityEvents(n, 3000000));
+
+    auto offline = [](unsigned long n, std::shared_ptr<ConnectivityEvents> events) {
+        return [n, events]() {
+            OfflineDynamicConnectivity connectivity(n);
+            for (auto& e : *events) {
+                if (e.kind == 0) connectivity.addEdge(e.a, e.b);
+                else if (e.kind == 1) connectivity.removeEdge(e.a, e.b);
+                else connectivity.query(e.a, e.b);
+            }
+            doNotOptimize(connectivity.solve());
+        };
+    };
+    registerBenchmark("dynamic_connectivity/offline/random/30000", offline(small_n, small_events), nullptr,
+                      small_events->size());
+    registerBenchmark("dynamic_connectivity/offline/random/3000000", offline(n, events), nullptr, events->size());
+
+    registerBenchmark("dynamic_connectivity/rebuild/random/30000", [small_n, small_events]() {
+        std::vector<std::pair<unsigned long, unsigned long> > present;
+        std::vector<bool> answers;
+        for (auto& e : *small_events) {
+            if (e.kind == 0) {
+                present.push_back(std::make_pair(e.a, e.b));
+            }
+            else if (e.kind == 1) {
+                auto it = std::find(present.begin(), present.end(), std::make_pair(e.a, e.b));
+                *it = present.back();
+                present.pop_back();
+            }
+            else {
+                WeightedQuickUnionUF uf(small_n);
+                for (auto& edge : present) uf.join(edge.first, edge.second);
+                answers.push_back(uf.connected(e.a, e.b));
+            }
+        }
+        doNotOptimize(answers);
+    }, nullptr, small_events->size());
+}
+
+#endif //ALGS_DYNAMIC_CONNECTIVITY_BENCH_H
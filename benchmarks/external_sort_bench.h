@@ -0,0 +1,41 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_EXTERNAL_SORT_BENCH_H
+#define ALGS_EXTERNAL_SORT_BENCH_H
+
+#include "bench_utils.h"
+#include "../external_sort.h"
+
+// Sorts v through an external sorter with the given options, writing the sorted elements back into v.
+void externalSortInts(IntVector& v, ExternalSortOptions options) {
+    ExternalSorter<int> sorter(options);
+    for (auto value : v) sorter.push(value);
+    size_t i = 0;
+    sorter.sort([&v, &i](int value) { v[i++] = value; });
+}
+
+void registerExternalSortBenchmarks() {
+    const size_t n = 16000000;
+    auto ints = std::make_shared<SharedSortInput<int> >(n, [n]() { return randomInts(n); });
+    auto suffix = "/int/" + std::to_string(n);
+
+    registerSortBenchmark<int>("external_sort/in_memory_pdq_sort" + suffix, ints, [](IntVector& v) {
+        pdq_sort(v.begin(), v.end());
+    });
+    // 64 MB of input against budgets of 16 and 1 MB, the latter needs more than one merge pass.
+    for (size_t budget_mb : {16, 1}) {
+        for (bool async_io : {false, true}) {
+            ExternalSortOptions options;
+            options.memory_budget = budget_mb << 20;
+            options.async_io = async_io;
+            auto name = "external_sort/budget:" + std::to_string(budget_mb) + "MB/" + (async_io ? "async" : "sync");
+            registerSortBenchmark<int>(name + suffix, ints, [options](IntVector& v) {
+                externalSortInts(v, options);
+            });
+        }
+    }
+}
+
+#endif //ALGS_EXTERNAL_SORT_BENCH_H
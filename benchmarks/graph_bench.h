@@ -0,0 +1,54 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_GRAPH_BENCH_H
+#define ALGS_GRAPH_BENCH_H
+
+#include "bench_utils.h"
+#include "../graph.h"
+#include "../digraph.h"
+
+void registerGraphBenchmarks() {
+    const int v = 100000;
+    auto edges = std::make_shared<std::vector<std::pair<unsigned long, unsigned long> > >(randomPairs(v, 2 * v));
+    auto e = edges->size();
+    auto suffix = "/" + std::to_string(v) + "x" + std::to_string(e);
+
+    registerBenchmark("graph/build" + suffix, [v, edges]() {
+        Graph g(v);
+        for (auto& p : *edges) g.addEdge((int) p.first, (int) p.second);
+        doNotOptimize(g.edgeCount());
+    }, nullptr, e);
+
+    auto g = std::make_shared<Graph>(v);
+    for (auto& p : *edges) g->addEdge((int) p.first, (int) p.second);
+
+    registerBenchmark("graph/dfs_paths" + suffix, [g]() {
+        GraphPaths paths(*g, 0);
+        doNotOptimize(paths.hasPathTo(v - 1));
+    }, nullptr, e);
+    registerBenchmark("graph/bfs_paths" + suffix, [g]() {
+        GraphBreadthFirstPaths paths(*g, 0);
+        doNotOptimize(paths.hasPathTo(v - 1));
+    }, nullptr, e);
+    registerBenchmark("graph/connected_components" + suffix, [g]() {
+        GraphConnectedComponents cc(*g);
+        doNotOptimize(cc.count());
+    }, nullptr, e);
+
+    registerBenchmark("digraph/build" + suffix, [v, edges]() {
+        Digraph g(v);
+        for (auto& p : *edges) g.addEdge((int) p.first, (int) p.second);
+        doNotOptimize(g.edgeCount());
+    }, nullptr, e);
+
+    auto dg = std::make_shared<Digraph>(v);
+    for (auto& p : *edges) dg->addEdge((int) p.first, (int) p.second);
+    registerBenchmark("digraph/strongly_connected_components" + suffix, [dg]() {
+        DigraphStronglyConnectedComponents scc(*dg);
+        doNotOptimize(scc.count());
+    }, nullptr, e);
+}
+
+#endif //ALGS_GRAPH_BENCH_H
@@ -0,0 +1,86 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_HASH_BENCH_H
+#define ALGS_HASH_BENCH_H
+
+#include <string>
+#include <functional>
+#include "bench_utils.h"
+#include "../hash.h"
+
+// The keys are made in the untimed setup and released once the benchmark has run.
+template <typename Hash>
+void registerIntHashBenchmark(const std::string& name, size_t n,
+                              std::shared_ptr<LazyBenchmarkData<std::vector<int> > > keys, Hash hash) {
+    registerBenchmark("hash/int/" + name, [keys, hash]() {
+        size_t sum = 0;
+        for (auto k : keys->get()) sum += hash(k);
+        doNotOptimize(sum);
+    }, [keys]() { keys->get(); }, n, [keys]() { keys->release(); });
+}
+
+template <typename Hash>
+void registerStringHashBenchmark(const std::string& name, size_t length, size_t count,
+                                 std::shared_ptr<LazyBenchmarkData<std::vector<std::string> > > keys, Hash hash) {
+    registerBenchmark("hash/string/" + name + "/length:" + std::to_string(length), [keys, hash]() {
+        size_t sum = 0;
+        for (auto& k : keys->get()) sum += hash(k);
+        doNotOptimize(sum);
+    }, [keys]() { keys->get(); }, count, [keys]() { keys->release(); });
+}
+
+// Hashes already mixed, so that only the cost of the reduction differs. The bucket count is read from memory
+// every time, as a table would.
+template <typename Reduce>
+void registerReductionBenchmark(const std::string& name, size_t n,
+                                std::shared_ptr<LazyBenchmarkData<std::vector<uint64_t> > > hashes,
+                                std::shared_ptr<size_t> buckets, Reduce reduce) {
+    registerBenchmark("hash/reduce/" + name + "/buckets:" + std::to_string(*buckets), [hashes, buckets, reduce]() {
+        size_t sum = 0;
+        for (auto h : hashes->get()) sum += reduce(h, *buckets);
+        doNotOptimize(sum);
+    }, [hashes]() { hashes->get(); }, n, [hashes]() { hashes->release(); });
+}
+
+void registerHashBenchmarks() {
+    const size_t n = 1 << 20;
+    auto ints = std::make_shared<LazyBenchmarkData<std::vector<int> > >([n]() { return randomInts(n); });
+    registerIntHashBenchmark("std_hash", n, ints, std::hash<int>());
+    registerIntHashBenchmark("fast_hash", n, ints, FastHash<int>());
+
+    for (size_t length : {4, 8, 16, 32, 64, 256, 4096}) {
+        // About 16 MB of text for every length.
+        auto count = std::max((size_t) 1024, (size_t) (16 << 20) / length);
+        auto keys = std::make_shared<LazyBenchmarkData<std::vector<std::string> > >([length, count]() {
+            Xoshiro256StarStar gen(bench_seed + length);
+            std::vector<std::string> keys(count);
+            for (auto& k : keys) {
+                k.resize(length);
+                for (auto& c : k) c = (char) ('a' + bounded_random(gen, 26));
+            }
+            return keys;
+        });
+        registerStringHashBenchmark("std_hash", length, count, keys, std::hash<std::string>());
+        registerStringHashBenchmark("fast_hash", length, count, keys, FastHash<std::string>());
+    }
+
+    auto hashes = std::make_shared<LazyBenchmarkData<std::vector<uint64_t> > >([n]() {
+        Xoshiro256StarStar gen(bench_seed);
+        std::vector<uint64_t> hashes(n);
+        for (auto& h : hashes) h = gen();
+        return hashes;
+    });
+    // A prime bucket count, as the chaining table starts with, and a power of two.
+    auto prime_buckets = std::make_shared<size_t>(786433);
+    auto power_buckets = std::make_shared<size_t>(1 << 20);
+    registerReductionBenchmark("modulo", n, hashes, prime_buckets, [](uint64_t h, size_t b) { return h % b; });
+    registerReductionBenchmark("reduce_range", n, hashes, prime_buckets, reduceRange);
+    registerReductionBenchmark("modulo", n, hashes, power_buckets, [](uint64_t h, size_t b) { return h % b; });
+    registerReductionBenchmark("fibonacci", n, hashes, power_buckets, [](uint64_t h, size_t b) {
+        return fibonacciBucket(h, __builtin_ctzll(b));
+    });
+}
+
+#endif //ALGS_HASH_BENCH_H
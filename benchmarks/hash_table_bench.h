@@ -0,0 +1,224 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_HASH_TABLE_BENCH_H
+#define ALGS_HASH_TABLE_BENCH_H
+
+#include <unordered_map>
+#include <thread>
+#include "bench_utils.h"
+#include "../hash_table.h"
+
+// Adapts std::unordered_map to the symbol table interface, to serve as a baseline.
+template <typename Key, typename Value>
+class StdUnorderedMapSymbolTable {
+public:
+    typedef std::pair<Value, bool> MaybeValue;
+
+    MaybeValue get(Key key) {
+        auto it = map.find(key);
+        if (it == map.end()) return std::make_pair(Value(), false);
+        return std::make_pair(it->second, true);
+    }
+
+    void insert(Key key, Value value) { map[key] = value; }
+    void remove(Key key) { map.erase(key); }
+    bool contains(Key key) { return map.count(key) != 0; }
+    size_t size() { return map.size(); }
+
+private:
+    std::unordered_map<Key, Value> map;
+};
+
+template <template <class, class, class...> class HashTable>
+void registerHashTableBenchmarks(const std::string& impl_name, std::shared_ptr<std::vector<int> > keys,
+                                 std::shared_ptr<std::vector<int> > missing_keys) {
+    auto n = keys->size();
+    auto prefix = "hash_table/" + impl_name;
+    auto suffix = "/int/" + std::to_string(n);
+
+    registerBenchmark(prefix + "/insert" + suffix, [keys]() {
+        HashTable<int, int> st;
+        for (auto k : *keys) st.insert(k, k);
+        doNotOptimize(st.size());
+    }, nullptr, n);
+
+    // The lookups run on a table filled by the untimed setup and freed once they are done.
+    auto filled = std::make_shared<std::unique_ptr<HashTable<int, int> > >();
+    auto fill = [keys, filled]() {
+        if (*filled) return;
+        filled->reset(new HashTable<int, int>());
+        for (auto k : *keys) (*filled)->insert(k, k);
+    };
+    auto release = [filled]() { filled->reset(); };
+    registerBenchmark(prefix + "/get_hit" + suffix, [keys, filled]() {
+        long sum = 0;
+        for (auto k : *keys) sum += (*filled)->get(k).first;
+        doNotOptimize(sum);
+    }, fill, n, release);
+    registerBenchmark(prefix + "/get_miss" + suffix, [missing_keys, filled]() {
+        long found = 0;
+        for (auto k : *missing_keys) found += (*filled)->contains(k);
+        doNotOptimize(found);
+    }, fill, missing_keys->size(), release);
+
+    registerBenchmark(prefix + "/insert_remove" + suffix, [keys]() {
+        HashTable<int, int> st;
+        for (auto k : *keys) st.insert(k, k);
+        for (auto k : *keys) st.remove(k);
+        doNotOptimize(st.size());
+    }, nullptr, 2 * n);
+}
+
+// Multiples of 1024, like ids with flags in their low bits or aligned addresses. Reducing them with a modulo
+// leaves most buckets unused.
+template <template <class, class, class...> class HashTable>
+void registerStridedKeyBenchmark(const std::string& impl_name, std::shared_ptr<std::vector<int> > keys) {
+    registerBenchmark("hash_table/" + impl_name + "/insert_get/strided/" + std::to_string(keys->size()), [keys]() {
+        HashTable<int, int> st;
+        for (auto k : *keys) st.insert(k, k);
+        long sum = 0;
+        for (auto k : *keys) sum += st.get(k).first;
+        doNotOptimize(sum);
+    }, nullptr, 2 * keys->size());
+}
+
+// Times every insert into a table that starts empty and grows to all the keys.
+template <template <class, class, class...> class HashTable>
+void registerHashTableLatencyBenchmark(const std::string& impl_name, std::shared_ptr<std::vector<int> > keys) {
+    registerLatencyBenchmark("hash_table/" + impl_name + "/insert_latency/int/" + std::to_string(keys->size()),
+                             [keys](LatencyRecorder& recorder) {
+        HashTable<int, int> st;
+        for (auto k : *keys) recorder.time([&st, k]() { st.insert(k, k); });
+        doNotOptimize(st.size());
+    }, nullptr, keys->size());
+}
+
+// Lookups in a Robin Hood table of fixed capacity filled up to load_percent, the table never resizes.
+void registerRobinHoodLoadBenchmarks(size_t capacity, int load_percent, std::shared_ptr<std::vector<int> > keys,
+                                     std::shared_ptr<std::vector<int> > missing_keys) {
+    auto n = capacity * load_percent / 100;
+    auto present = std::make_shared<std::vector<int> >(keys->begin(), keys->begin() + n);
+    // Filled by the untimed setup and freed once the lookups are done, as in registerHashTableBenchmarks.
+    auto st = std::make_shared<std::unique_ptr<RobinHoodHashSymbolTable<int, int> > >();
+    auto fill = [present, st, capacity]() {
+        if (*st) return;
+        st->reset(new RobinHoodHashSymbolTable<int, int>(capacity, 0.99));
+        for (auto k : *present) (*st)->insert(k, k);
+    };
+    auto release = [st]() { st->reset(); };
+    auto suffix = "/load:" + std::to_string(load_percent) + "/int/" + std::to_string(capacity);
+
+    registerBenchmark("hash_table/robin_hood/get_hit" + suffix, [present, st]() {
+        long sum = 0;
+        for (auto k : *present) sum += (*st)->get(k).first;
+        doNotOptimize(sum);
+    }, fill, n, release);
+    registerBenchmark("hash_table/robin_hood/get_miss" + suffix, [missing_keys, st]() {
+        long found = 0;
+        for (auto k : *missing_keys) found += (*st)->contains(k);
+        doNotOptimize(found);
+    }, fill, missing_keys->size(), release);
+    registerLatencyBenchmark("hash_table/robin_hood/insert_latency" + suffix, [present, capacity](LatencyRecorder& recorder) {
+        RobinHoodHashSymbolTable<int, int> filling(capacity, 0.99);
+        for (auto k : *present) recorder.time([&filling, k]() { filling.insert(k, k); });
+        doNotOptimize(filling.size());
+    }, nullptr, n);
+}
+
+struct HashTableOperation {
+    enum Kind { Get, Insert, Remove } kind;
+    int key;
+};
+
+// Threads share the operations round robin on a table filled with every other key in the untimed setup, so that
+// about half of the gets hit and the size stays put.
+template <typename HashTable>
+void registerConcurrentHashTableBenchmark(const std::string& impl_name, int key_range,
+                                          std::shared_ptr<std::vector<HashTableOperation> > operations,
+                                          int read_percent, unsigned long threads) {
+    auto st = std::make_shared<std::unique_ptr<HashTable> >();
+    registerBenchmark("hash_table/concurrent/" + impl_name + "/mixed/reads:" + std::to_string(read_percent)
+                      + "/threads:" + std::to_string(threads), [st, operations, threads]() {
+        auto& table = **st;
+        std::vector<std::thread> workers;
+        for (unsigned long t = 0; t < threads; t++) {
+            workers.emplace_back([&table, &operations, t, threads]() {
+                auto& ops = *operations;
+                long found = 0;
+                for (size_t i = t; i < ops.size(); i += threads) {
+                    switch (ops[i].kind) {
+                        case HashTableOperation::Get: found += table.get(ops[i].key).second; break;
+                        case HashTableOperation::Insert: table.insert(ops[i].key, ops[i].key); break;
+                        case HashTableOperation::Remove: table.remove(ops[i].key); break;
+                    }
+                }
+                doNotOptimize(found);
+            });
+        }
+        for (auto& w : workers) w.join();
+        doNotOptimize(table.size());
+    }, [st, key_range]() {
+        st->reset(new HashTable());
+        for (int k = 0; k < key_range; k += 2) (*st)->insert(k, k);
+    }, operations->size());
+}
+
+void registerHashTableBenchmarks() {
+    for (size_t n : {100000, 1000000}) {
+        auto keys = std::make_shared<std::vector<int> >(randomInts(n));
+        // Random ints from another seed, almost none of them are keys.
+        auto missing_keys = std::make_shared<std::vector<int> >(randomInts(n, bench_seed + 1));
+        registerHashTableBenchmarks<ChainingHashSymbolTable>("separate_chaining", keys, missing_keys);
+        registerHashTableBenchmarks<LinearProbingHashSymbolTable>("linear_probing", keys, missing_keys);
+        registerHashTableBenchmarks<SwissHashSymbolTable>("swiss_table", keys, missing_keys);
+        registerHashTableBenchmarks<PooledChainingHashSymbolTable>("pooled_chaining", keys, missing_keys);
+        registerHashTableBenchmarks<RobinHoodHashSymbolTable>("robin_hood", keys, missing_keys);
+        registerHashTableBenchmarks<StdUnorderedMapSymbolTable>("std_unordered_map", keys, missing_keys);
+    }
+
+    auto keys = std::make_shared<std::vector<int> >(randomInts(1000000));
+    registerHashTableLatencyBenchmark<ChainingHashSymbolTable>("separate_chaining", keys);
+    registerHashTableLatencyBenchmark<LinearProbingHashSymbolTable>("linear_probing", keys);
+    registerHashTableLatencyBenchmark<SwissHashSymbolTable>("swiss_table", keys);
+    registerHashTableLatencyBenchmark<PooledChainingHashSymbolTable>("pooled_chaining", keys);
+    registerHashTableLatencyBenchmark<RobinHoodHashSymbolTable>("robin_hood", keys);
+    registerHashTableLatencyBenchmark<StdUnorderedMapSymbolTable>("std_unordered_map", keys);
+
+    auto strided_keys = std::make_shared<std::vector<int> >(1 << 16);
+    for (size_t i = 0; i < strided_keys->size(); i++) (*strided_keys)[i] = (int) (i * 1024);
+    registerStridedKeyBenchmark<ChainingHashSymbolTable>("separate_chaining", strided_keys);
+    registerStridedKeyBenchmark<LinearProbingHashSymbolTable>("linear_probing", strided_keys);
+    registerStridedKeyBenchmark<SwissHashSymbolTable>("swiss_table", strided_keys);
+
+    const size_t capacity = 1 << 20;
+    auto load_keys = std::make_shared<std::vector<int> >(randomInts(capacity));
+    auto load_missing_keys = std::make_shared<std::vector<int> >(randomInts(capacity / 4, bench_seed + 1));
+    for (int load_percent : {50, 75, 90, 95}) {
+        registerRobinHoodLoadBenchmarks(capacity, load_percent, load_keys, load_missing_keys);
+    }
+
+    // The writes are half inserts and half removals of random keys.
+    const int key_range = 1 << 20;
+    const size_t operation_count = 1 << 21;
+    for (int read_percent : {50, 90, 99}) {
+        Xoshiro256StarStar gen(bench_seed);
+        auto operations = std::make_shared<std::vector<HashTableOperation> >(operation_count);
+        for (auto& op : *operations) {
+            auto roll = (int) bounded_random(gen, 200);
+            op.kind = roll < 2 * read_percent ? HashTableOperation::Get
+                    : roll % 2 ? HashTableOperation::Insert : HashTableOperation::Remove;
+            op.key = (int) bounded_random(gen, key_range);
+        }
+        // Thread counts past the hardware concurrency show how each version copes with oversubscription.
+        for (unsigned long threads = 1; threads <= 64; threads *= 2) {
+            registerConcurrentHashTableBenchmark<ConcurrentHashSymbolTable<int, int> >(
+                    "striped_seqlock", key_range, operations, read_percent, threads);
+            registerConcurrentHashTableBenchmark<LockedHashSymbolTable<int, int> >(
+                    "mutex_swiss_table", key_range, operations, read_percent, threads);
+        }
+    }
+}
+
+#endif //ALGS_HASH_TABLE_BENCH_H
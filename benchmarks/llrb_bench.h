@@ -0,0 +1,37 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_LLRB_BENCH_H
+#define ALGS_LLRB_BENCH_H
+
+#include "bench_utils.h"
+#include "../llrb.h"
+
+void registerLLRBBenchmarks() {
+    auto keys = std::make_shared<std::vector<int> >(randomInts(100000));
+    auto n = keys->size();
+    auto suffix = "/int/" + std::to_string(n);
+
+    registerBenchmark("llrb/insert" + suffix, [keys]() {
+        LLRB<int, int> tree;
+        for (auto k : *keys) tree.insert(k, k);
+        doNotOptimize(tree.size());
+    }, nullptr, n);
+
+    auto filled = std::make_shared<LLRB<int, int> >();
+    for (auto k : *keys) filled->insert(k, k);
+    registerBenchmark("llrb/get_hit" + suffix, [keys, filled]() {
+        long sum = 0;
+        for (auto k : *keys) sum += filled->get(k).first;
+        doNotOptimize(sum);
+    }, nullptr, n);
+
+    registerBenchmark("llrb/rank" + suffix, [keys, filled]() {
+        size_t sum = 0;
+        for (auto k : *keys) sum += filled->rank(k);
+        doNotOptimize(sum);
+    }, nullptr, n);
+}
+
+#endif //ALGS_LLRB_BENCH_H
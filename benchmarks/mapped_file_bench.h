@@ -0,0 +1,86 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_MAPPED_FILE_BENCH_H
+#define ALGS_MAPPED_FILE_BENCH_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+#include "bench_utils.h"
+#include "../mapped_file.h"
+#include "../unionfind.h"
+
+// Writes a union-find file of n elements and m random pairs, like data/mediumUF.txt.
+void writeUFFile(const std::string& file_name, unsigned long n, size_t m) {
+    std::ofstream f(file_name);
+    f << n << "\n";
+    for (auto& p : randomPairs(n, m)) f << p.first << " " << p.second << "\n";
+}
+
+void registerMappedFileBenchmarks() {
+    const unsigned long n = 10000000;
+    const size_t m = 1 << 23;
+    // The file, about 128 MB, is written by the first benchmark that runs and read once untimed, so that it is
+    // in the page cache. Its name is unique to the process, and it is removed when the benchmarks are destroyed
+    // at exit.
+    auto file_name = std::shared_ptr<std::string>(new std::string(), [](std::string* name) {
+        if (!name->empty()) std::remove(name->c_str());
+        delete name;
+    });
+    auto prepare = [file_name]() {
+        if (!file_name->empty()) return;
+        char path[] = "/tmp/algs_bench_uf_XXXXXX";
+        int fd = mkstemp(path);
+        if (fd < 0) {
+            std::perror("mkstemp");
+            std::exit(1);
+        }
+        close(fd);
+        *file_name = path;
+        writeUFFile(*file_name, n, m);
+        PairFileReader reader(*file_name);
+        unsigned long count, a, b;
+        reader.readCount(count);
+        while (reader.readPair(a, b)) {}
+    };
+    auto workload = "/random/" + std::to_string(m);
+
+    registerBenchmark("uf_file/parse/fstream" + workload, [file_name]() {
+        std::fstream f(*file_name, std::fstream::in);
+        unsigned long count, a, b, sum = 0;
+        f >> count;
+        while (f >> a >> b) sum += a ^ b;
+        doNotOptimize(sum);
+    }, prepare, m);
+    registerBenchmark("uf_file/parse/mapped" + workload, [file_name]() {
+        PairFileReader reader(*file_name);
+        unsigned long count, sum = 0;
+        reader.readCount(count);
+        reader.forEachBatch<unsigned long>([&sum](std::pair<unsigned long, unsigned long>* pairs, size_t k) {
+            for (size_t i = 0; i < k; i++) sum += pairs[i].first ^ pairs[i].second;
+        });
+        doNotOptimize(sum);
+    }, prepare, m);
+
+    registerBenchmark("uf_file/load_and_join/fstream/compact" + workload, [file_name]() {
+        std::fstream f(*file_name, std::fstream::in);
+        unsigned long count, a, b;
+        f >> count;
+        CompactUF<> uf(count);
+        while (f >> a >> b) uf.join(a, b);
+        doNotOptimize(uf.count());
+    }, prepare, m);
+    registerBenchmark("uf_file/load_and_join/mapped/compact" + workload, [file_name]() {
+        PairFileReader reader(*file_name);
+        unsigned long count;
+        reader.readCount(count);
+        CompactUF<> uf(count);
+        joinPairs(reader, uf);
+        doNotOptimize(uf.count());
+    }, prepare, m);
+}
+
+#endif //ALGS_MAPPED_FILE_BENCH_H
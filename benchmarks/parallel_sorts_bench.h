@@ -0,0 +1,65 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_PARALLEL_SORTS_BENCH_H
+#define ALGS_PARALLEL_SORTS_BENCH_H
+
+#include "bench_utils.h"
+#include "../parallel_sorts.h"
+
+// Thread counts 1, 2, 4, ... up to and including the hardware concurrency.
+std::vector<size_t> benchThreadCounts() {
+    std::vector<size_t> counts;
+    auto max_threads = ThreadPool::defaultThreadCount();
+    for (size_t t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+    return counts;
+}
+
+// Registers one benchmark per thread count. The pools are shared by every benchmark of a thread count, and
+// their threads only start when the first of them runs.
+void registerPooledSortBenchmarks(const std::string& name, std::shared_ptr<SharedSortInput<int> > input,
+                                  std::function<void(IntVector&, ThreadPool&)> sort) {
+    static std::vector<std::shared_ptr<std::unique_ptr<ThreadPool> > > pools;
+    auto counts = benchThreadCounts();
+    for (size_t i = 0; i < counts.size(); i++) {
+        if (pools.size() <= i) pools.push_back(std::make_shared<std::unique_ptr<ThreadPool> >());
+        auto pool = pools[i];
+        auto threads = counts[i];
+        registerSortBenchmark<int>(name + "/threads:" + std::to_string(threads), input, [pool, sort](IntVector& v) {
+            sort(v, **pool);
+        }, [pool, threads]() {
+            if (!*pool) pool->reset(new ThreadPool(threads));
+        });
+    }
+}
+
+void registerParallelSortBenchmarks() {
+    const size_t n = 4000000;
+    auto ints = std::make_shared<SharedSortInput<int> >(n, [n]() { return randomInts(n); });
+    auto suffix = "/int/" + std::to_string(n);
+
+    registerSortBenchmark<int>("parallel_sorts/std_stable_sort" + suffix, ints, [](IntVector& v) {
+        std::stable_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("parallel_sorts/std_sort" + suffix, ints, [](IntVector& v) {
+        std::sort(v.begin(), v.end());
+    });
+    registerPooledSortBenchmarks("parallel_sorts/parallel_merge_sort" + suffix, ints, [](IntVector& v, ThreadPool& pool) {
+        parallel_merge_sort(v.begin(), v.end(), pool);
+    });
+    registerPooledSortBenchmarks("parallel_sorts/parallel_sample_sort" + suffix, ints, [](IntVector& v, ThreadPool& pool) {
+        parallel_sample_sort(v.begin(), v.end(), pool);
+    });
+
+    // Well beyond the last level cache, where memory bandwidth is the limit. 1 thread is the sequential baseline.
+    const size_t large_n = 32000000;
+    auto large_ints = std::make_shared<SharedSortInput<int> >(large_n, [large_n]() { return randomInts(large_n); });
+    registerPooledSortBenchmarks("parallel_sorts/parallel_sample_sort/int/" + std::to_string(large_n), large_ints,
+                                 [](IntVector& v, ThreadPool& pool) {
+        parallel_sample_sort(v.begin(), v.end(), pool);
+    });
+}
+
+#endif //ALGS_PARALLEL_SORTS_BENCH_H
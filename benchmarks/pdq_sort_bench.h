@@ -0,0 +1,44 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_PDQ_SORT_BENCH_H
+#define ALGS_PDQ_SORT_BENCH_H
+
+#include "bench_utils.h"
+#include "../pdq_sort.h"
+
+// Registers pdq_sort next to the other quick sorts and std::sort, on the same input.
+template <typename T>
+void registerPdqSortComparison(const std::string& type_name, const std::vector<T>& input) {
+    typedef std::vector<T> Vector;
+    auto suffix = "/" + type_name + "/" + std::to_string(input.size());
+    registerSortBenchmark<T>("pdq_sort/pdq_sort" + suffix, input, [](Vector& v) {
+        pdq_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<T>("pdq_sort/quick_sort" + suffix, input, [](Vector& v) {
+        quick_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<T>("pdq_sort/quick_sort_3_way" + suffix, input, [](Vector& v) {
+        quick_sort_3_way(v.begin(), v.end());
+    });
+    registerSortBenchmark<T>("pdq_sort/std_sort" + suffix, input, [](Vector& v) {
+        std::sort(v.begin(), v.end());
+    });
+}
+
+void registerPdqSortBenchmarks() {
+    const size_t n = 1000000;
+    registerPdqSortComparison<int>("int", randomInts(n));
+    registerPdqSortComparison<double>("double", randomDoubles(n));
+    registerPdqSortComparison<std::string>("string", randomStrings(n / 10));
+
+    for (auto& pattern : intPatterns()) {
+        registerSortBenchmark<int>("sorts/patterns/pdq_sort/int/" + pattern + "/" + std::to_string(n / 10),
+                                   patternedInts(pattern, n / 10), [](IntVector& v) {
+            pdq_sort(v.begin(), v.end());
+        });
+    }
+}
+
+#endif //ALGS_PDQ_SORT_BENCH_H
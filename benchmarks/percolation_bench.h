@@ -0,0 +1,133 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_PERCOLATION_BENCH_H
+#define ALGS_PERCOLATION_BENCH_H
+
+#include "bench_utils.h"
+#include "../thread_pool.h"
+#include "../applications/percolation.h"
+
+// PercolationStats as it was: a new Percolation per experiment, and a std::random_device and std::mt19937
+// created for every site drawn.
+double legacyPercolationStats(size_t n, size_t t) {
+    double sum = 0;
+    for (size_t k = 0; k < t; k++) {
+        Percolation p(n);
+        auto max_sites = p.getSiteCount();
+        while (p.getOpenSiteCount() < max_sites) {
+            size_t i, j;
+            do {
+                std::random_device rd;
+                std::mt19937 gen(rd());
+                i = std::uniform_int_distribution<unsigned long long>{1, n}(gen);
+                j = std::uniform_int_distribution<unsigned long long>{1, n}(gen);
+            }
+            while (p.isOpen(i, j));
+            p.open(i, j);
+            if (p.percolates()) break;
+        }
+        sum += (double) p.getOpenSiteCount() / max_sites;
+    }
+    return sum / t;
+}
+
+// Opens every element of a system in random order, setup resets it. items is the number of elements, so the
+// per item time is the cost of one opening. The system is made by the first setup and freed by the teardown.
+template <typename System>
+void registerPercolationSweepBenchmark(const std::string& name, size_t elements,
+                                       std::function<std::shared_ptr<System>()> make) {
+    auto system = std::make_shared<std::shared_ptr<System> >();
+    auto gen = std::make_shared<Xoshiro256StarStar>(bench_seed);
+    registerBenchmark("percolation/sweep/" + name, [system, gen]() {
+        auto& p = **system;
+        auto count = p.getElementCount();
+        for (size_t k = 0; k < count; k++) p.openRandomBlockedElement(*gen);
+        doNotOptimize(p.getLargestClusterSize());
+    }, [system, make]() {
+        if (!*system) *system = make();
+        (*system)->reset();
+    }, elements, [system]() { system->reset(); });
+}
+
+template <typename Lattice>
+size_t bondCount(const Lattice& lattice) {
+    size_t count = 0;
+    lattice.forEachBond([&count](typename Lattice::Index, typename Lattice::Index) { count++; });
+    return count;
+}
+
+void registerPercolationBenchmarks() {
+    const size_t n = 200;
+    const size_t t = 64;
+    auto workload = "/n:" + std::to_string(n) + "/t:" + std::to_string(t);
+
+    registerBenchmark("percolation/stats/legacy" + workload, [n, t]() {
+        doNotOptimize(legacyPercolationStats(n, t));
+    }, nullptr, t);
+
+    // The pools are shared by the stats and curve benchmarks of a thread count, their threads start when the
+    // first of them runs.
+    for (size_t threads = 1; threads <= 4; threads *= 2) {
+        auto pool = std::make_shared<std::unique_ptr<ThreadPool> >();
+        auto start_pool = [pool, threads]() {
+            if (!*pool) pool->reset(new ThreadPool(threads));
+        };
+        registerBenchmark("percolation/stats/pool" + workload + "/threads:" + std::to_string(threads), [n, t, pool]() {
+            PercolationStats stats(n, t, **pool, bench_seed);
+            doNotOptimize(stats.mean());
+        }, start_pool, t);
+        registerBenchmark("percolation/curve/pool" + workload + "/threads:" + std::to_string(threads), [n, t, pool]() {
+            PercolationCurve curve(n, t, **pool, bench_seed);
+            doNotOptimize(curve.percolationProbability(0.59));
+        }, start_pool, t);
+    }
+
+    // About 2^20 sites in every dimension.
+    registerPercolationSweepBenchmark<PercolationSystem<SquareLattice> >("site/d:2/n:1024",
+            SquareLattice(1024).siteCount(), []() {
+        return std::make_shared<PercolationSystem<SquareLattice> >(SquareLattice(1024));
+    });
+    registerPercolationSweepBenchmark<PercolationSystem<CubicLattice> >("site/d:3/n:102",
+            CubicLattice(102).siteCount(), []() {
+        return std::make_shared<PercolationSystem<CubicLattice> >(CubicLattice(102));
+    });
+    registerPercolationSweepBenchmark<PercolationSystem<HypercubicLattice<4> > >("site/d:4/n:32",
+            HypercubicLattice<4>(32).siteCount(), []() {
+        return std::make_shared<PercolationSystem<HypercubicLattice<4> > >(HypercubicLattice<4>(32));
+    });
+    registerPercolationSweepBenchmark<PercolationSystem<HypercubicLattice<5> > >("site/d:5/n:16",
+            HypercubicLattice<5>(16).siteCount(), []() {
+        return std::make_shared<PercolationSystem<HypercubicLattice<5> > >(HypercubicLattice<5>(16));
+    });
+    registerPercolationSweepBenchmark<PercolationSystem<SquareLattice, BondPercolation> >("bond/d:2/n:1024",
+            bondCount(SquareLattice(1024)), []() {
+        return std::make_shared<PercolationSystem<SquareLattice, BondPercolation> >(SquareLattice(1024));
+    });
+    registerPercolationSweepBenchmark<PercolationSystem<CubicLattice, BondPercolation> >("bond/d:3/n:102",
+            bondCount(CubicLattice(102)), []() {
+        return std::make_shared<PercolationSystem<CubicLattice, BondPercolation> >(CubicLattice(102));
+    });
+
+    // The 1024x1024 grid as a Graph, neighbors come from adjacency lists rather than fixed offsets. The deleter
+    // of the system keeps the graph alive.
+    const int side = 1024;
+    registerPercolationSweepBenchmark<PercolationSystem<GraphLattice> >("site/graph/n:1024", side * side, [side]() {
+        auto grid = std::make_shared<Graph>(side * side);
+        std::vector<int> top, bottom;
+        for (int i = 0; i < side; i++) {
+            for (int j = 0; j < side; j++) {
+                if (j + 1 < side) grid->addEdge(i * side + j, i * side + j + 1);
+                if (i + 1 < side) grid->addEdge(i * side + j, (i + 1) * side + j);
+            }
+            top.push_back(i);
+            bottom.push_back((side - 1) * side + i);
+        }
+        return std::shared_ptr<PercolationSystem<GraphLattice> >(
+                new PercolationSystem<GraphLattice>(GraphLattice(*grid, top, bottom)),
+                [grid](PercolationSystem<GraphLattice>* p) { delete p; });
+    });
+}
+
+#endif //ALGS_PERCOLATION_BENCH_H
@@ -0,0 +1,52 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_RADIX_SORT_BENCH_H
+#define ALGS_RADIX_SORT_BENCH_H
+
+#include "bench_utils.h"
+#include "../radix_sort.h"
+#include "../pdq_sort.h"
+
+void registerRadixSortBenchmarks() {
+    const size_t n = 1000000;
+    auto suffix = [](const std::string& type, size_t size) { return "/" + type + "/" + std::to_string(size); };
+
+    auto ints = randomInts(n);
+    registerSortBenchmark<int>("radix_sort/radix_sort" + suffix("int", n), ints, [](IntVector& v) {
+        radix_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("radix_sort/pdq_sort" + suffix("int", n), ints, [](IntVector& v) {
+        pdq_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("radix_sort/std_sort" + suffix("int", n), ints, [](IntVector& v) {
+        std::sort(v.begin(), v.end());
+    });
+
+    typedef std::vector<double> DoubleVector;
+    auto doubles = randomDoubles(n);
+    registerSortBenchmark<double>("radix_sort/radix_sort" + suffix("double", n), doubles, [](DoubleVector& v) {
+        radix_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<double>("radix_sort/std_sort" + suffix("double", n), doubles, [](DoubleVector& v) {
+        std::sort(v.begin(), v.end());
+    });
+
+    typedef std::vector<std::string> StringVector;
+    auto strings = randomStrings(n / 10);
+    registerSortBenchmark<std::string>("radix_sort/string_radix_sort" + suffix("string", n / 10), strings,
+                                       [](StringVector& v) {
+        string_radix_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<std::string>("radix_sort/quick_sort_3_way" + suffix("string", n / 10), strings,
+                                       [](StringVector& v) {
+        quick_sort_3_way(v.begin(), v.end());
+    });
+    registerSortBenchmark<std::string>("radix_sort/std_sort" + suffix("string", n / 10), strings,
+                                       [](StringVector& v) {
+        std::sort(v.begin(), v.end());
+    });
+}
+
+#endif //ALGS_RADIX_SORT_BENCH_H
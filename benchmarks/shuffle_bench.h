@@ -0,0 +1,58 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_SHUFFLE_BENCH_H
+#define ALGS_SHUFFLE_BENCH_H
+
+#include "bench_utils.h"
+#include "parallel_sorts_bench.h"
+#include "../sorts.h"
+#include "../parallel_sorts.h"
+#include "../fast_random.h"
+
+// knuth_shuffle as it was before the fast engines, a new std::mt19937 per call and a distribution per element.
+template <typename RandomIt>
+void mt19937KnuthShuffle(RandomIt first, RandomIt last) {
+    std::mt19937 gen(bench_seed);
+    int index = 0;
+    for (auto i = first; i != last; ++i, ++index) {
+        auto r = std::uniform_int_distribution<>{0, index}(gen);
+        std::swap(*i, *(first + r));
+    }
+}
+
+void registerShuffleBenchmarks() {
+    const size_t n = 1000000;
+    auto ints = std::make_shared<SharedSortInput<int> >(n, [n]() { return randomInts(n); });
+    auto suffix = "/int/" + std::to_string(n);
+
+    registerSortBenchmark<int>("shuffle/knuth_shuffle/mt19937" + suffix, ints, [](IntVector& v) {
+        mt19937KnuthShuffle(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("shuffle/knuth_shuffle/xoshiro256starstar" + suffix, ints, [](IntVector& v) {
+        Xoshiro256StarStar gen(bench_seed);
+        knuth_shuffle(v.begin(), v.end(), gen);
+    });
+    registerSortBenchmark<int>("shuffle/knuth_shuffle/pcg32" + suffix, ints, [](IntVector& v) {
+        Pcg32 gen(bench_seed);
+        knuth_shuffle(v.begin(), v.end(), gen);
+    });
+    registerSortBenchmark<int>("shuffle/std_shuffle/mt19937_64" + suffix, ints, [](IntVector& v) {
+        std::mt19937_64 gen(bench_seed);
+        std::shuffle(v.begin(), v.end(), gen);
+    });
+
+    const size_t large_n = 16000000;
+    auto large_ints = std::make_shared<SharedSortInput<int> >(large_n, [large_n]() { return randomInts(large_n); });
+    auto large_suffix = "/int/" + std::to_string(large_n);
+    registerSortBenchmark<int>("shuffle/knuth_shuffle/xoshiro256starstar" + large_suffix, large_ints, [](IntVector& v) {
+        Xoshiro256StarStar gen(bench_seed);
+        knuth_shuffle(v.begin(), v.end(), gen);
+    });
+    registerPooledSortBenchmarks("shuffle/parallel_shuffle" + large_suffix, large_ints, [](IntVector& v, ThreadPool& pool) {
+        parallel_shuffle(v.begin(), v.end(), pool, bench_seed);
+    });
+}
+
+#endif //ALGS_SHUFFLE_BENCH_H
@@ -0,0 +1,77 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_SORTING_NETWORKS_BENCH_H
+#define ALGS_SORTING_NETWORKS_BENCH_H
+
+#include "bench_utils.h"
+#include "../sorts.h"
+#include "../sorting_networks.h"
+
+std::vector<std::pair<std::string, SimdLevel> > benchSimdLevels() {
+    std::vector<std::pair<std::string, SimdLevel> > levels = {std::make_pair("scalar", SimdLevel::None)};
+    if (detectSimdLevel() >= SimdLevel::SSE41) levels.push_back(std::make_pair("sse41", SimdLevel::SSE41));
+    if (detectSimdLevel() >= SimdLevel::AVX2) levels.push_back(std::make_pair("avx2", SimdLevel::AVX2));
+    return levels;
+}
+
+// Runs sort with the kernels of level, restoring the detected level afterwards.
+template <typename T>
+std::function<void(std::vector<T>&)> withSimdLevel(SimdLevel level, std::function<void(std::vector<T>&)> sort) {
+    return [level, sort](std::vector<T>& v) {
+        auto saved = sortingNetworkLevel();
+        sortingNetworkLevel() = level;
+        sort(v);
+        sortingNetworkLevel() = saved;
+    };
+}
+
+void registerSortingNetworkBenchmarks() {
+    const size_t n = 1000000;
+    typedef std::vector<float> FloatVector;
+    auto ints = randomInts(n);
+    auto doubles = randomDoubles(n);
+    FloatVector floats(doubles.begin(), doubles.end());
+
+    for (auto& level : benchSimdLevels()) {
+        auto suffix = [&level](const std::string& type, size_t size) {
+            return "/" + level.first + "/" + type + "/" + std::to_string(size);
+        };
+
+        // Many independent small ranges, where the base case is all there is.
+        for (size_t small : {8, 16, 32}) {
+            registerSortBenchmark<int>("sorting_networks/small_ranges/" + std::to_string(small) + suffix("int", n),
+                                       ints, withSimdLevel<int>(level.second, [small](IntVector& v) {
+                for (size_t i = 0; i + small <= v.size(); i += small) {
+                    if (!sorting_network_sort(v.begin() + i, v.begin() + i + small, std::less<int>())) {
+                        insertion_sort(v.begin() + i, v.begin() + i + small);
+                    }
+                }
+            }));
+        }
+
+        registerSortBenchmark<int>("sorting_networks/merge_sort" + suffix("int", n), ints,
+                                   withSimdLevel<int>(level.second, [](IntVector& v) {
+            merge_sort(v.begin(), v.end());
+        }));
+        registerSortBenchmark<float>("sorting_networks/merge_sort" + suffix("float", n), floats,
+                                     withSimdLevel<float>(level.second, [](FloatVector& v) {
+            merge_sort(v.begin(), v.end());
+        }));
+        registerSortBenchmark<int>("sorting_networks/quick_sort" + suffix("int", n), ints,
+                                   withSimdLevel<int>(level.second, [](IntVector& v) {
+            quick_sort(v.begin(), v.end());
+        }));
+        registerSortBenchmark<int>("sorting_networks/quick_sort_3_way" + suffix("int", n), ints,
+                                   withSimdLevel<int>(level.second, [](IntVector& v) {
+            quick_sort_3_way(v.begin(), v.end());
+        }));
+        registerSortBenchmark<int>("sorting_networks/intro_sort" + suffix("int", n), ints,
+                                   withSimdLevel<int>(level.second, [](IntVector& v) {
+            intro_sort(v.begin(), v.end());
+        }));
+    }
+}
+
+#endif //ALGS_SORTING_NETWORKS_BENCH_H
@@ -0,0 +1,73 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_SORTS_BENCH_H
+#define ALGS_SORTS_BENCH_H
+
+#include "bench_utils.h"
+#include "../sorts.h"
+#include "../priority_queue.h"
+
+typedef std::vector<int> IntVector;
+
+void registerSortBenchmarks() {
+    // Quadratic sorts get a smaller input, so that a full run stays reasonable.
+    const size_t small_n = 2000;
+    const size_t n = 100000;
+    auto small_ints = randomInts(small_n);
+    auto ints = randomInts(n);
+    auto suffix = [](size_t size) { return "/int/" + std::to_string(size); };
+
+    registerSortBenchmark<int>("sorts/selection_sort" + suffix(small_n), small_ints, [](IntVector& v) {
+        selection_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/insertion_sort" + suffix(small_n), small_ints, [](IntVector& v) {
+        insertion_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/shell_sort" + suffix(n), ints, [](IntVector& v) {
+        shell_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/merge_sort" + suffix(n), ints, [](IntVector& v) {
+        merge_sort(v.begin(), v.end());
+    });
+    // Scratch buffer allocated once, outside of the timed runs.
+    auto merge_sorter = std::make_shared<MergeSorter<int> >();
+    registerSortBenchmark<int>("sorts/merge_sort_reused_scratch" + suffix(n), ints, [merge_sorter](IntVector& v) {
+        merge_sorter->sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/bottom_up_merge_sort" + suffix(n), ints, [](IntVector& v) {
+        bottom_up_merge_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/quick_sort" + suffix(n), ints, [](IntVector& v) {
+        quick_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/quick_sort_3_way" + suffix(n), ints, [](IntVector& v) {
+        quick_sort_3_way(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/heap_sort" + suffix(n), ints, [](IntVector& v) {
+        heap_sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/std_sort" + suffix(n), ints, [](IntVector& v) {
+        std::sort(v.begin(), v.end());
+    });
+    registerSortBenchmark<int>("sorts/std_stable_sort" + suffix(n), ints, [](IntVector& v) {
+        std::stable_sort(v.begin(), v.end());
+    });
+
+    for (auto& pattern : intPatterns()) {
+        auto input = patternedInts(pattern, n);
+        auto pattern_suffix = "/int/" + pattern + "/" + std::to_string(n);
+        registerSortBenchmark<int>("sorts/patterns/quick_sort" + pattern_suffix, input, [](IntVector& v) {
+            quick_sort(v.begin(), v.end());
+        });
+        registerSortBenchmark<int>("sorts/patterns/intro_sort" + pattern_suffix, input, [](IntVector& v) {
+            intro_sort(v.begin(), v.end());
+        });
+        registerSortBenchmark<int>("sorts/patterns/std_sort" + pattern_suffix, input, [](IntVector& v) {
+            std::sort(v.begin(), v.end());
+        });
+    }
+}
+
+#endif //ALGS_SORTS_BENCH_H
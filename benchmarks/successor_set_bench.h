@@ -0,0 +1,141 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_SUCCESSOR_SET_BENCH_H
+#define ALGS_SUCCESSOR_SET_BENCH_H
+
+#include <set>
+#include "bench_utils.h"
+#include "../unionfind.h"
+#include "../successor_set.h"
+
+// Successor with delete on std::set, the remaining integers are the keys.
+class StdSetSuccessorOfIncreasingNumbers {
+public:
+    StdSetSuccessorOfIncreasingNumbers(unsigned long n) : limit(n) {
+        for (unsigned long i = 0; i < n; i++) remaining.insert(remaining.end(), (uint32_t) i);
+    }
+
+    void remove(unsigned long i) {
+        remaining.erase((uint32_t) i);
+    }
+
+    unsigned long successor(unsigned long i) {
+        auto it = remaining.lower_bound((uint32_t) i);
+        return it == remaining.end() ? limit : *it;
+    }
+
+private:
+    unsigned long limit;
+    std::set<uint32_t> remaining;
+};
+
+struct SuccessorOperation {
+    enum Kind { Insert, Remove, Successor, Predecessor } kind;
+    uint32_t value;
+};
+
+// Removes the integers of removals in order, each followed by a successor query of a random integer.
+template <typename Impl>
+void registerSuccessorWithDeleteBenchmark(const std::string& name, unsigned long n,
+                                          std::shared_ptr<std::vector<std::pair<uint32_t, uint32_t> > > operations) {
+    auto successors = std::make_shared<std::unique_ptr<Impl> >();
+    registerBenchmark("successor_set/remove_successor/" + name + "/" + std::to_string(n), [successors, operations]() {
+        unsigned long sum = 0;
+        for (auto& op : *operations) {
+            (*successors)->remove(op.first);
+            sum += (*successors)->successor(op.second);
+        }
+        doNotOptimize(sum);
+    }, [successors, n]() { successors->reset(new Impl(n)); }, 2 * operations->size());
+}
+
+// Random inserts, removals, successor and predecessor queries on a set that starts empty.
+template <typename Set>
+void registerSuccessorSetMixedBenchmark(const std::string& name, unsigned long n,
+                                        std::shared_ptr<std::vector<SuccessorOperation> > operations,
+                                        std::function<Set()> make) {
+    auto set = std::make_shared<Set>(make());
+    registerBenchmark("successor_set/mixed/" + name + "/" + std::to_string(n), [set, operations]() {
+        unsigned long sum = 0;
+        for (auto& op : *operations) {
+            switch (op.kind) {
+                case SuccessorOperation::Insert: set->insert(op.value); break;
+                case SuccessorOperation::Remove: set->erase(op.value); break;
+                case SuccessorOperation::Successor: sum += set->successor(op.value); break;
+                case SuccessorOperation::Predecessor: sum += set->predecessor(op.value); break;
+            }
+        }
+        doNotOptimize(sum);
+    }, [set, make]() { *set = make(); }, operations->size());
+}
+
+// SuccessorSet and std::set behind the same names, for registerSuccessorSetMixedBenchmark.
+class BenchSuccessorSet {
+public:
+    explicit BenchSuccessorSet(unsigned long n) : set(n) {}
+    void insert(unsigned long x) { set.insert(x); }
+    void erase(unsigned long x) { set.remove(x); }
+    unsigned long successor(unsigned long x) { return set.successor(x); }
+    unsigned long predecessor(unsigned long x) { return set.predecessor(x); }
+
+private:
+    SuccessorSet set;
+};
+
+class BenchStdSet {
+public:
+    explicit BenchStdSet(unsigned long n) : limit(n) {}
+    void insert(unsigned long x) { set.insert((uint32_t) x); }
+    void erase(unsigned long x) { set.erase((uint32_t) x); }
+
+    unsigned long successor(unsigned long x) {
+        auto it = set.lower_bound((uint32_t) x);
+        return it == set.end() ? limit : *it;
+    }
+
+    unsigned long predecessor(unsigned long x) {
+        auto it = set.upper_bound((uint32_t) x);
+        return it == set.begin() ? limit : *--it;
+    }
+
+private:
+    unsigned long limit;
+    std::set<uint32_t> set;
+};
+
+void registerSuccessorSetBenchmarks() {
+    const unsigned long n = 1UL << 22;
+    Xoshiro256StarStar gen(bench_seed);
+
+    // Half of the integers removed in random order, as ids handed out by an allocator.
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0U);
+    std::shuffle(order.begin(), order.end(), gen);
+    auto removals = std::make_shared<std::vector<std::pair<uint32_t, uint32_t> > >();
+    for (unsigned long i = 0; i < n / 2; i++) {
+        removals->push_back(std::make_pair(order[i], (uint32_t) bounded_random(gen, n)));
+    }
+    registerSuccessorWithDeleteBenchmark<SuccessorOfIncreasingNumbers>("bitset_tree", n, removals);
+    registerSuccessorWithDeleteBenchmark<UFSuccessorOfIncreasingNumbers>("union_find", n, removals);
+    registerSuccessorWithDeleteBenchmark<StdSetSuccessorOfIncreasingNumbers>("std_set", n, removals);
+
+    // Twice as many inserts as removals, so that the set fills up to a few million keys.
+    auto operations = std::make_shared<std::vector<SuccessorOperation> >(n);
+    for (auto& op : *operations) {
+        auto kind = bounded_random(gen, 8);
+        op.kind = kind < 4 ? SuccessorOperation::Insert
+                : kind < 6 ? SuccessorOperation::Remove
+                : kind < 7 ? SuccessorOperation::Successor : SuccessorOperation::Predecessor;
+        op.value = (uint32_t) bounded_random(gen, n);
+    }
+    registerSuccessorSetMixedBenchmark<BenchSuccessorSet>("bitset_tree", n, operations, [n]() {
+        return BenchSuccessorSet(n);
+    });
+    registerSuccessorSetMixedBenchmark<BenchStdSet>("std_set", n, operations, [n]() {
+        return BenchStdSet(n);
+    });
+}
+
+#endif //ALGS_SUCCESSOR_SET_BENCH_H
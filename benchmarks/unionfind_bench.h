@@ -0,0 +1,204 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_UNIONFIND_BENCH_H
+#define ALGS_UNIONFIND_BENCH_H
+
+#include <thread>
+#include "bench_utils.h"
+#include "../unionfind.h"
+
+typedef std::vector<std::pair<unsigned long, unsigned long> > UFPairs;
+
+template <typename Impl>
+void registerUFBenchmark(const std::string& name, const std::string& workload, unsigned long n,
+                         std::shared_ptr<UFPairs> pairs) {
+    registerBenchmark("unionfind/" + name + "/join/" + workload,
+                      [n, pairs]() {
+        Impl uf(n);
+        for (auto& p : *pairs) {
+            uf.join(p.first, p.second);
+        }
+        doNotOptimize(uf.connected(0, n - 1));
+    }, nullptr, pairs->size());
+}
+
+// Joins the pairs from threads threads, each taking every threads-th pair.
+template <typename Impl>
+void registerConcurrentUFBenchmark(const std::string& name, const std::string& workload, unsigned long n,
+                                   std::shared_ptr<UFPairs> pairs, unsigned long threads) {
+    registerBenchmark("unionfind/concurrent/" + name + "/join/" + workload + "/threads:" + std::to_string(threads),
+                      [n, pairs, threads]() {
+        Impl uf(n);
+        std::vector<std::thread> workers;
+        for (unsigned long t = 0; t < threads; t++) {
+            workers.emplace_back([&uf, &pairs, t, threads]() {
+                auto& p = *pairs;
+                for (size_t i = t; i < p.size(); i += threads) uf.join(p[i].first, p[i].second);
+            });
+        }
+        for (auto& w : workers) w.join();
+        doNotOptimize(uf.count());
+    }, nullptr, pairs->size());
+}
+
+// Union-find shared by the join and connected benchmarks of one implementation, so that only one of them is
+// alive at a time. Pairs and queries are generated by the first benchmark that runs.
+template <typename Impl>
+struct UFBatchState {
+    unsigned long n;
+    UFPairs pairs;
+    UFPairs queries;
+    std::unique_ptr<Impl> uf;
+    bool joined = false;
+
+    void generate() {
+        if (pairs.empty()) {
+            pairs = randomPairs(n, n / 2);
+            queries = randomPairs(n, n / 4, bench_seed + 1);
+        }
+    }
+
+    void join(bool batched) {
+        if (batched) uf->joinBatch(pairs.begin(), pairs.end());
+        else for (auto& p : pairs) uf->join(p.first, p.second);
+    }
+};
+
+// Joins n / 2 random pairs, either one join call at a time or through joinBatch. The union-find is created in
+// the untimed setup.
+template <typename Impl>
+void registerUFBatchJoinBenchmark(const std::string& name, std::shared_ptr<UFBatchState<Impl> > state,
+                                  bool batched) {
+    auto mode = batched ? "/join_batch/random/" : "/join/random/";
+    registerBenchmark("unionfind/" + name + mode + std::to_string(state->n), [state, batched]() {
+        state->join(batched);
+        state->joined = true;
+        doNotOptimize(state->uf->count());
+    }, [state]() {
+        state->generate();
+        state->uf.reset();
+        state->uf.reset(new Impl(state->n));
+        state->joined = false;
+    }, state->n / 2);
+}
+
+// Answers n / 4 random connected queries after the joins, one call at a time or through connectedBatch.
+template <typename Impl>
+void registerUFBatchConnectedBenchmark(const std::string& name, std::shared_ptr<UFBatchState<Impl> > state,
+                                       bool batched) {
+    auto mode = batched ? "/connected_batch/random/" : "/connected/random/";
+    auto answers = std::make_shared<std::vector<char> >();
+    registerBenchmark("unionfind/" + name + mode + std::to_string(state->n), [state, batched, answers]() {
+        auto& queries = state->queries;
+        if (batched) {
+            state->uf->connectedBatch(queries.begin(), queries.end(), answers->begin());
+        }
+        else {
+            auto out = answers->begin();
+            for (auto& q : queries) *out++ = state->uf->connected(q.first, q.second);
+        }
+        doNotOptimize(answers->data());
+    }, [state, answers]() {
+        state->generate();
+        if (!state->joined) {
+            state->uf.reset();
+            state->uf.reset(new Impl(state->n));
+            state->join(true);
+            state->joined = true;
+        }
+        answers->resize(state->queries.size());
+    }, state->n / 4);
+}
+
+template <typename Impl>
+void registerUFBatchBenchmarks(const std::string& name, unsigned long n) {
+    auto state = std::make_shared<UFBatchState<Impl> >();
+    state->n = n;
+    registerUFBatchJoinBenchmark<Impl>(name, state, false);
+    registerUFBatchJoinBenchmark<Impl>(name, state, true);
+    registerUFBatchConnectedBenchmark<Impl>(name, state, false);
+    registerUFBatchConnectedBenchmark<Impl>(name, state, true);
+}
+
+// Loads the pairs of a union-find data file. Returns false if the file is missing.
+bool loadUFFile(const std::string& file_name, unsigned long& n, UFPairs& pairs) {
+    std::fstream f(file_name, std::fstream::in);
+    if (!f) return false;
+    f >> n;
+    unsigned long a, b;
+    while (f >> a >> b) {
+        pairs.push_back(std::make_pair(a, b));
+    }
+    return true;
+}
+
+// Places copies of the pairs side by side, chains each copy to the next one, and relabels all elements with a
+// random permutation so that the joins of one copy are spread over the whole array.
+UFPairs scaleUFPairs(unsigned long n, const UFPairs& pairs, unsigned long copies) {
+    std::vector<unsigned long> labels(n * copies);
+    std::iota(labels.begin(), labels.end(), 0UL);
+    std::shuffle(labels.begin(), labels.end(), std::mt19937_64(bench_seed));
+    UFPairs scaled;
+    scaled.reserve((pairs.size() + 1) * copies);
+    for (unsigned long c = 0; c < copies; c++) {
+        for (auto& p : pairs) scaled.push_back(std::make_pair(labels[c * n + p.first], labels[c * n + p.second]));
+        if (c + 1 < copies) scaled.push_back(std::make_pair(labels[c * n], labels[(c + 1) * n]));
+    }
+    return scaled;
+}
+
+void registerUnionFindBenchmarks() {
+    // Quick find does O(n) work per join, so it gets a smaller random workload.
+    const unsigned long small_n = 5000;
+    const unsigned long n = 1000000;
+    auto small_pairs = std::make_shared<UFPairs>(randomPairs(small_n, small_n));
+    auto pairs = std::make_shared<UFPairs>(randomPairs(n, n));
+
+    auto small_workload = "random/" + std::to_string(small_n);
+    auto workload = "random/" + std::to_string(n);
+    registerUFBenchmark<QuickFindUF>("quick_find", small_workload, small_n, small_pairs);
+    registerUFBenchmark<QuickUnionUF>("quick_union", small_workload, small_n, small_pairs);
+    registerUFBenchmark<WeightedQuickUnionUF>("weighted_quick_union", workload, n, pairs);
+    registerUFBenchmark<WeightedQuickUnionUFHeight>("weighted_quick_union_height", workload, n, pairs);
+    registerUFBenchmark<CompactUF<> >("compact", workload, n, pairs);
+    registerUFBenchmark<CompactUF<uint32_t, TrackComponentMax> >("compact_max", workload, n, pairs);
+
+    // 2^26 elements take 1.5 GB in weighted quick union and 256 MB in the compact one, larger than the last level
+    // cache, so that nearly every parent hop is a cache miss.
+    const unsigned long batch_n = 1UL << 26;
+    registerUFBatchBenchmarks<WeightedQuickUnionUF>("weighted_quick_union", batch_n);
+    registerUFBatchBenchmarks<CompactUF<> >("compact", batch_n);
+
+    // Thread counts past the hardware concurrency show how each version copes with oversubscription.
+    for (unsigned long threads = 1; threads <= 64; threads *= 2) {
+        registerConcurrentUFBenchmark<ConcurrentUF>("lock_free", workload, n, pairs, threads);
+        registerConcurrentUFBenchmark<LockedUF<WeightedQuickUnionUF> >("mutex_weighted_quick_union", workload, n,
+                                                                        pairs, threads);
+    }
+
+    unsigned long medium_n = 0;
+    auto medium_pairs = std::make_shared<UFPairs>();
+    if (loadUFFile("data/mediumUF.txt", medium_n, *medium_pairs)) {
+        registerUFBenchmark<QuickFindUF>("quick_find", "mediumUF", medium_n, medium_pairs);
+        registerUFBenchmark<QuickUnionUF>("quick_union", "mediumUF", medium_n, medium_pairs);
+        registerUFBenchmark<WeightedQuickUnionUF>("weighted_quick_union", "mediumUF", medium_n, medium_pairs);
+        registerUFBenchmark<WeightedQuickUnionUFHeight>("weighted_quick_union_height", "mediumUF", medium_n, medium_pairs);
+        registerUFBenchmark<CompactUF<> >("compact", "mediumUF", medium_n, medium_pairs);
+
+        // 625 elements fit in L1, the scaled up copies do not fit in any cache.
+        const unsigned long copies = 4096;
+        auto scaled_pairs = std::make_shared<UFPairs>(scaleUFPairs(medium_n, *medium_pairs, copies));
+        auto scaled_n = medium_n * copies;
+        auto scaled_workload = "mediumUF_x" + std::to_string(copies);
+        registerUFBenchmark<WeightedQuickUnionUF>("weighted_quick_union", scaled_workload, scaled_n, scaled_pairs);
+        registerUFBenchmark<WeightedQuickUnionUFHeight>("weighted_quick_union_height", scaled_workload, scaled_n,
+                                                        scaled_pairs);
+        registerUFBenchmark<CompactUF<> >("compact", scaled_workload, scaled_n, scaled_pairs);
+        registerUFBenchmark<CompactUF<uint32_t, TrackComponentMax> >("compact_max", scaled_workload, scaled_n,
+                                                                     scaled_pairs);
+    }
+}
+
+#endif //ALGS_UNIONFIND_BENCH_H
@@ -11,13 +11,7 @@
 #include <boost/iterator/zip_iterator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include "vendor/transform_output_iterator.hpp"
-
-struct VertexPair : std::tuple<int, int> {};
-std::istream& operator>>(std::istream& st, VertexPair& p) {
-    st >> std::get<0>(p);
-    st >> std::get<1>(p);
-    return st;
-}
+#include "mapped_file.h"
 
 class Digraph {
     using VertexID = int;
@@ -40,18 +34,19 @@ public:
     }
 
     Digraph(const std::string& filename) {
-        std::fstream f(filename, std::fstream::in);
-        if (!f) {
+        PairFileReader reader(filename);
+        if (!reader.isOpen()) {
             std::cerr << "Error opening file.\n";
             return;
         }
 
-        f >> vertex_count;
+        reader.readCount(vertex_count);
         reserveAdjacencyList();
 
-        std::for_each(std::istream_iterator<VertexPair>(f), std::istream_iterator<VertexPair>(), [this](VertexPair p) {
-            this->addEdge(std::get<0>(p), std::get<1>(p));
-        });
+        VertexID v, w;
+        while (reader.readPair(v, w)) {
+            addEdge(v, w);
+        }
     }
 
     void addEdge(VertexID v, VertexID w) {
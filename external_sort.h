@@ -0,0 +1,502 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_EXTERNAL_SORT_H
+#define ALGS_EXTERNAL_SORT_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <future>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "pdq_sort.h"
+#include "priority_queue.h"
+#include "thread_pool.h"
+
+/**
+ * External merge sort, for inputs that do not fit in memory.
+ *
+ * Elements are collected into a chunk as large as the memory budget allows. Every full chunk is sorted with
+ * pdq_sort and spilled as a binary run to a temporary file. Runs are then merged k at a time through a
+ * PriorityQueue of run heads, in as many passes as needed to keep one buffer per run within the budget.
+ *
+ * With async_io, the file accesses run on a separate I/O thread: a chunk is written while the next one is
+ * filled (which halves the chunk size), and every run reader reads its next buffer while the current one is
+ * merged, as does the output writer.
+ *
+ * Elements are written to disk byte for byte, so they must be trivially copyable. Ties are merged in run order,
+ * but runs are sorted with an unstable sort, so the external sort is not stable.
+ */
+
+struct ExternalSortOptions {
+    // Bytes of elements held in memory at once, by the chunk being sorted or by the merge buffers.
+    size_t memory_budget = 64 << 20;
+    // Directory of the temporary run files.
+    std::string temp_directory = "/tmp";
+    // Overlap reading and writing the files with sorting and merging.
+    bool async_io = true;
+};
+
+// Merge buffers are kept at least this large, the run count of a merge pass is reduced instead.
+const size_t external_sort_min_buffer_bytes = 64 << 10;
+
+/**
+ * Temporary file holding one sorted run. The file is unlinked right after it is created, so it disappears
+ * when closed, even if the program does not get to clean up.
+ */
+class ExternalRunFile {
+public:
+    explicit ExternalRunFile(const std::string& directory) : file(nullptr), elements(0) {
+        std::string path = directory + "/algs_external_sort_XXXXXX";
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back('\0');
+        int fd = mkstemp(name.data());
+        if (fd < 0) return;
+        unlink(name.data());
+        file = fdopen(fd, "w+b");
+        if (!file) close(fd);
+    }
+
+    ExternalRunFile(const ExternalRunFile&) = delete;
+    ExternalRunFile& operator=(const ExternalRunFile&) = delete;
+
+    ~ExternalRunFile() {
+        if (file) std::fclose(file);
+    }
+
+    bool ok() const { return file != nullptr; }
+
+    std::FILE* file;
+    size_t elements;
+};
+
+/**
+ * Sequential reader of a binary file of elements. While the current buffer is consumed, the next one is read
+ * on the io pool, if there is one.
+ */
+template <typename T>
+class ExternalRunReader {
+public:
+    ExternalRunReader(std::FILE* _file, size_t element_count, size_t buffer_elements, ThreadPool* _io)
+            : file(_file), remaining(element_count), capacity(std::max((size_t) 1, buffer_elements)), position(0),
+              io(_io), ok(true) {
+        scheduleRead();
+        nextBuffer();
+    }
+
+    ExternalRunReader(const ExternalRunReader&) = delete;
+    ExternalRunReader& operator=(const ExternalRunReader&) = delete;
+
+    ~ExternalRunReader() {
+        if (pending.valid()) pending.wait();
+    }
+
+    bool empty() const { return position == current.size(); }
+    const T& front() const { return current[position]; }
+
+    void pop() {
+        if (++position == current.size()) nextBuffer();
+    }
+
+    // False if a read came back short.
+    bool good() const { return ok; }
+
+private:
+    bool readInto(std::vector<T>& buffer, size_t n) {
+        buffer.resize(n);
+        return std::fread(buffer.data(), sizeof(T), n, file) == n;
+    }
+
+    void scheduleRead() {
+        size_t n = std::min(remaining, capacity);
+        remaining -= n;
+        if (io) {
+            pending = io->submit([this, n]() { return readInto(next, n); });
+        }
+        else {
+            ok = readInto(next, n) && ok;
+        }
+    }
+
+    void nextBuffer() {
+        if (pending.valid()) ok = pending.get() && ok;
+        std::swap(current, next);
+        position = 0;
+        if (remaining > 0) scheduleRead();
+        else next.clear();
+    }
+
+    std::FILE* file;
+    size_t remaining;
+    size_t capacity;
+    std::vector<T> current, next;
+    size_t position;
+    ThreadPool* io;
+    std::future<bool> pending;
+    bool ok;
+};
+
+/**
+ * Sequential writer of a binary file of elements. A full buffer is written on the io pool, if there is one,
+ * while the next one is filled.
+ */
+template <typename T>
+class ExternalRunWriter {
+public:
+    ExternalRunWriter(std::FILE* _file, size_t buffer_elements, ThreadPool* _io)
+            : file(_file), capacity(std::max((size_t) 1, buffer_elements)), io(_io), ok(true) {
+        current.reserve(capacity);
+    }
+
+    ExternalRunWriter(const ExternalRunWriter&) = delete;
+    ExternalRunWriter& operator=(const ExternalRunWriter&) = delete;
+
+    ~ExternalRunWriter() {
+        if (pending.valid()) pending.wait();
+    }
+
+    void push(const T& value) {
+        current.push_back(value);
+        if (current.size() == capacity) flush();
+    }
+
+    // Writes the buffered elements and waits for all writes, returns false if any of them failed.
+    bool finish() {
+        flush();
+        if (pending.valid()) ok = pending.get() && ok;
+        return ok && std::fflush(file) == 0;
+    }
+
+private:
+    void flush() {
+        if (current.empty()) return;
+        if (pending.valid()) ok = pending.get() && ok;
+        std::swap(current, writing);
+        current.clear();
+        if (io) {
+            pending = io->submit([this]() { return writeAll(); });
+        }
+        else {
+            ok = writeAll() && ok;
+        }
+    }
+
+    bool writeAll() {
+        return std::fwrite(writing.data(), sizeof(T), writing.size(), file) == writing.size();
+    }
+
+    std::FILE* file;
+    size_t capacity;
+    std::vector<T> current, writing;
+    ThreadPool* io;
+    std::future<bool> pending;
+    bool ok;
+};
+
+// Head element of a run in the merge queue.
+template <typename T>
+struct ExternalMergeHead {
+    T value;
+    size_t run;
+};
+
+// Orders heads by value and equal values by run, PriorityQueue removes the least head first.
+template <typename T, typename Compare>
+struct ExternalMergeHeadCompare {
+    bool operator()(const ExternalMergeHead<T>& a, const ExternalMergeHead<T>& b) const {
+        if (comp(a.value, b.value)) return true;
+        if (comp(b.value, a.value)) return false;
+        return a.run < b.run;
+    }
+    Compare comp;
+};
+
+template <typename T, typename Compare = std::less<T> >
+class ExternalSorter {
+    static_assert(std::is_trivially_copyable<T>::value, "Runs are stored byte for byte, T must be trivially copyable.");
+
+public:
+    ExternalSorter(ExternalSortOptions _options = ExternalSortOptions())
+            : options(_options), chunk_capacity(chunkCapacity(_options)), merge_passes(0), ok(true),
+              io(_options.async_io ? new ThreadPool(1) : nullptr) {
+        chunk.reserve(chunk_capacity);
+    }
+
+    ~ExternalSorter() {
+        if (spilling.valid()) spilling.wait();
+    }
+
+    void push(const T& value) {
+        chunk.push_back(value);
+        if (chunk.size() == chunk_capacity) spill();
+    }
+
+    /**
+     * Calls output(value) for every pushed element, in sorted order. Returns false if a temporary file could
+     * not be created, written or read back, in which case the output is incomplete. The sorter is empty
+     * afterwards.
+     */
+    template <typename Output>
+    bool sort(Output output) {
+        merge_passes = 0;
+        if (runs.empty()) {
+            // Everything fit into the budget, no file needed.
+            pdq_sort(chunk.begin(), chunk.end(), comp);
+            for (auto& value : chunk) output(value);
+            chunk.clear();
+            return ok;
+        }
+
+        if (!chunk.empty()) spill();
+        waitForSpill();
+        // The chunks are not needed anymore, release their memory for the merge buffers.
+        std::vector<T>().swap(chunk);
+        std::vector<T>().swap(spill_chunk);
+
+        size_t fan_in = maxFanIn();
+        while (ok && runs.size() > fan_in) {
+            // Merge the oldest runs first, so that every element takes part in about the same number of passes.
+            std::vector<std::unique_ptr<ExternalRunFile> > group;
+            for (size_t i = 0; i < fan_in; i++) group.push_back(std::move(runs[i]));
+            runs.erase(runs.begin(), runs.begin() + fan_in);
+
+            std::unique_ptr<ExternalRunFile> merged(new ExternalRunFile(options.temp_directory));
+            if (!merged->ok()) return fail("Error creating a temporary run file.\n");
+            ExternalRunWriter<T> writer(merged->file, bufferElements(fan_in), io.get());
+            size_t count = 0;
+            merge(group, [&writer, &count](const T& value) {
+                writer.push(value);
+                count++;
+            });
+            if (!writer.finish()) return fail("Error writing a temporary run file.\n");
+            merged->elements = count;
+            runs.push_back(std::move(merged));
+            merge_passes++;
+        }
+
+        if (ok) {
+            merge(runs, output);
+            merge_passes++;
+        }
+        runs.clear();
+        return ok;
+    }
+
+    // Number of runs spilled so far.
+    size_t runCount() const { return run_count; }
+    // Merge passes done by the last call to sort, the final one included.
+    size_t mergePasses() const { return merge_passes; }
+
+private:
+    static size_t chunkCapacity(const ExternalSortOptions& options) {
+        size_t chunks = options.async_io ? 2 : 1;
+        return std::max((size_t) 1, options.memory_budget / sizeof(T) / chunks);
+    }
+
+    // Buffers held while merging k runs, one per run and one for the output, twice that when reading ahead.
+    size_t buffersFor(size_t k) const {
+        return (k + 1) * (options.async_io ? 2 : 1);
+    }
+
+    size_t bufferElements(size_t k) const {
+        return std::max((size_t) 1, options.memory_budget / buffersFor(k) / sizeof(T));
+    }
+
+    size_t maxFanIn() const {
+        size_t fan_in = 2;
+        while (buffersFor(fan_in + 1) * external_sort_min_buffer_bytes <= options.memory_budget) fan_in++;
+        return fan_in;
+    }
+
+    bool fail(const char* message) {
+        std::cerr << message;
+        ok = false;
+        return false;
+    }
+
+    void waitForSpill() {
+        if (spilling.valid() && !spilling.get()) fail("Error writing a temporary run file.\n");
+    }
+
+    void spill() {
+        pdq_sort(chunk.begin(), chunk.end(), comp);
+        std::unique_ptr<ExternalRunFile> run(new ExternalRunFile(options.temp_directory));
+        if (!run->ok()) {
+            fail("Error creating a temporary run file.\n");
+            chunk.clear();
+            return;
+        }
+        run->elements = chunk.size();
+        auto file = run->file;
+        runs.push_back(std::move(run));
+        run_count++;
+
+        // The previous chunk has to be written before its vector can be filled again.
+        waitForSpill();
+        std::swap(chunk, spill_chunk);
+        chunk.clear();
+        chunk.reserve(chunk_capacity);
+        auto& data = spill_chunk;
+        auto write = [file, &data]() {
+            return std::fwrite(data.data(), sizeof(T), data.size(), file) == data.size() && std::fflush(file) == 0;
+        };
+        if (io) {
+            spilling = io->submit(write);
+        }
+        else if (!write()) {
+            fail("Error writing a temporary run file.\n");
+        }
+    }
+
+    template <typename Output>
+    void merge(std::vector<std::unique_ptr<ExternalRunFile> >& group, Output output) {
+        size_t buffer_elements = bufferElements(group.size());
+        std::vector<std::unique_ptr<ExternalRunReader<T> > > readers;
+        PriorityQueue<ExternalMergeHead<T>, ExternalMergeHeadCompare<T, Compare> > heads;
+        for (size_t r = 0; r < group.size(); r++) {
+            std::rewind(group[r]->file);
+            readers.emplace_back(new ExternalRunReader<T>(group[r]->file, group[r]->elements, buffer_elements, io.get()));
+            if (!readers[r]->empty()) heads.insert(ExternalMergeHead<T>{readers[r]->front(), r});
+        }
+
+        while (!heads.empty()) {
+            auto head = heads.removeMax();
+            output(head.value);
+            auto& reader = *readers[head.run];
+            reader.pop();
+            if (!reader.empty()) heads.insert(ExternalMergeHead<T>{reader.front(), head.run});
+        }
+
+        for (auto& reader : readers) {
+            if (!reader->good()) fail("Error reading a temporary run file.\n");
+        }
+    }
+
+    ExternalSortOptions options;
+    size_t chunk_capacity;
+    std::vector<T> chunk, spill_chunk;
+    std::vector<std::unique_ptr<ExternalRunFile> > runs;
+    size_t run_count = 0;
+    size_t merge_passes;
+    bool ok;
+    Compare comp;
+    std::unique_ptr<ThreadPool> io;
+    std::future<bool> spilling;
+};
+
+/**
+ * Sorts the binary file of elements at input_path into output_path, using the budget and temporary directory of
+ * options. Returns false if a file could not be opened, read or written.
+ */
+template <typename T, typename Compare = std::less<T> >
+bool external_sort_file(const std::string& input_path, const std::string& output_path,
+                        ExternalSortOptions options = ExternalSortOptions()) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> input(std::fopen(input_path.c_str(), "rb"), std::fclose);
+    if (!input) {
+        std::cerr << "Error opening file.\n";
+        return false;
+    }
+    std::fseek(input.get(), 0, SEEK_END);
+    auto elements = (size_t) std::ftell(input.get()) / sizeof(T);
+    std::rewind(input.get());
+
+    std::unique_ptr<ThreadPool> io(options.async_io ? new ThreadPool(1) : nullptr);
+    ExternalSorter<T, Compare> sorter(options);
+    {
+        ExternalRunReader<T> reader(input.get(), elements, external_sort_min_buffer_bytes / sizeof(T), io.get());
+        for (; !reader.empty(); reader.pop()) sorter.push(reader.front());
+        if (!reader.good()) {
+            std::cerr << "Error reading file.\n";
+            return false;
+        }
+    }
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> output(std::fopen(output_path.c_str(), "wb"), std::fclose);
+    if (!output) {
+        std::cerr << "Error opening file.\n";
+        return false;
+    }
+    ExternalRunWriter<T> writer(output.get(), external_sort_min_buffer_bytes / sizeof(T), io.get());
+    bool sorted = sorter.sort([&writer](const T& value) { writer.push(value); });
+    return writer.finish() && sorted;
+}
+
+void testExternalSort() {
+    std::cout << "Test external merge sort.\n";
+    std::fstream f;
+    f.open("data/mediumUF.txt", std::fstream::in);
+    if ( (f.rdstate() & std::ifstream::failbit ) != 0 ) {
+        std::cerr << "Error opening file.\n";
+        return;
+    }
+
+    // Sort the connection log with room for 256 connections only, so that it is spilled to many runs.
+    struct Connection {
+        int p, q;
+        bool operator<(const Connection& other) const { return p < other.p || (p == other.p && q < other.q); }
+    };
+    ExternalSortOptions options;
+    options.memory_budget = 256 * sizeof(Connection);
+    ExternalSorter<Connection> sorter(options);
+    std::vector<Connection> expected;
+    unsigned long n;
+    f >> n;
+    Connection c;
+    while (f >> c.p >> c.q) {
+        sorter.push(c);
+        expected.push_back(c);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<Connection> sorted;
+    sorter.sort([&sorted](const Connection& connection) { sorted.push_back(connection); });
+    bool same = sorted.size() == expected.size() &&
+                std::equal(sorted.begin(), sorted.end(), expected.begin(), [](const Connection& a, const Connection& b) {
+                    return a.p == b.p && a.q == b.q;
+                });
+    std::cout << "Sorted " << sorted.size() << " connections in " << sorter.runCount() << " runs and "
+              << sorter.mergePasses() << " merge passes: " << same << "\n";
+    // A second sort that fits into the budget merges nothing.
+    for (size_t i = 0; i < 10; i++) sorter.push(expected[i]);
+    size_t second_count = 0;
+    sorter.sort([&second_count](const Connection&) { second_count++; });
+    std::cout << "Sorted " << second_count << " connections again in " << sorter.mergePasses() << " merge passes\n";
+    std::cout << "First connections: ";
+    for (size_t i = 0; i < 3 && i < sorted.size(); i++) std::cout << "(" << sorted[i].p << "," << sorted[i].q << ") ";
+    std::cout << "\n";
+
+    std::string input_path = options.temp_directory + "/algs_external_sort_test.bin";
+    std::string output_path = options.temp_directory + "/algs_external_sort_test.sorted.bin";
+    std::mt19937 gen(9);
+    std::vector<int> ints(100000);
+    for (auto& i : ints) i = (int) gen();
+    std::FILE* file = std::fopen(input_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error opening file.\n";
+        return;
+    }
+    std::fwrite(ints.data(), sizeof(int), ints.size(), file);
+    std::fclose(file);
+
+    options.memory_budget = 1 << 20;
+    bool done = external_sort_file<int>(input_path, output_path, options);
+    std::vector<int> result(ints.size());
+    file = std::fopen(output_path.c_str(), "rb");
+    bool read = file && std::fread(result.data(), sizeof(int), result.size(), file) == result.size();
+    if (file) std::fclose(file);
+    std::sort(ints.begin(), ints.end());
+    std::cout << "Sorted a binary file of 100000 ints: " << (done && read && result == ints) << "\n";
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+}
+
+#endif //ALGS_EXTERNAL_SORT_H
@@ -0,0 +1,190 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_FAST_RANDOM_H
+#define ALGS_FAST_RANDOM_H
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include <iostream>
+#include <type_traits>
+
+/**
+ * Small, fast pseudo random engines and unbiased bounded integers, for shuffling.
+ *
+ * Both engines satisfy UniformRandomBitGenerator, so they also plug into the distributions of <random> and into
+ * std::shuffle. They are not cryptographically secure.
+ */
+
+// Expands one 64 bit seed into the state of the other engines, so that similar seeds give unrelated states.
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    uint64_t operator()() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+// xoshiro256** by Blackman and Vigna, 256 bits of state and 64 bit outputs.
+class Xoshiro256StarStar {
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256StarStar(uint64_t seed = 0) {
+        SplitMix64 mix(seed);
+        for (auto& word : s) word = mix();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Advances the state by 2^128 outputs. Engines jumped a different number of times from the same seed give
+    // non-overlapping streams, e.g. one per thread.
+    void jump() {
+        static const uint64_t polynomial[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                              0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (auto p : polynomial) {
+            for (int b = 0; b < 64; b++) {
+                if (p & (1ULL << b)) {
+                    for (int i = 0; i < 4; i++) t[i] ^= s[i];
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; i++) s[i] = t[i];
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t s[4];
+};
+
+// PCG32 (XSH RR) by O'Neill, 64 bits of state and 32 bit outputs.
+class Pcg32 {
+public:
+    typedef uint32_t result_type;
+
+    explicit Pcg32(uint64_t seed = 0, uint64_t stream = 0) : state(0), increment((stream << 1) | 1) {
+        (*this)();
+        state += SplitMix64(seed)();
+        (*this)();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        auto shifted = (uint32_t) (((old >> 18) ^ old) >> 27);
+        auto rotation = (uint32_t) (old >> 59);
+        return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+    }
+
+private:
+    uint64_t state;
+    uint64_t increment;
+};
+
+/**
+ * Uniform integer in [0, range), range > 0, with Lemire's nearly divisionless method: the high half of the
+ * product of a random word and range is the result, and only the rare products whose low half falls in the
+ * biased zone need a division and another draw. The engine has to produce full 32 or 64 bit words.
+ */
+template <typename Engine>
+uint64_t bounded_random(Engine& gen, uint64_t range) {
+    typedef typename Engine::result_type Word;
+    static_assert(std::is_same<Word, uint32_t>::value || std::is_same<Word, uint64_t>::value,
+                  "Engines have to produce full 32 or 64 bit words.");
+    static_assert(Engine::min() == 0 && Engine::max() == std::numeric_limits<Word>::max(),
+                  "Engines have to produce full 32 or 64 bit words.");
+
+    if (sizeof(Word) == 4 && range < ((uint64_t) 1 << 32)) {
+        uint64_t m = (uint64_t) (uint32_t) gen() * range;
+        auto low = (uint32_t) m;
+        if (low < range) {
+            auto threshold = (uint32_t) (((uint64_t) 1 << 32) - range) % (uint32_t) range;
+            while (low < threshold) {
+                m = (uint64_t) (uint32_t) gen() * range;
+                low = (uint32_t) m;
+            }
+        }
+        return m >> 32;
+    }
+
+    auto draw = [&gen]() {
+        if (sizeof(Word) == 8) return (uint64_t) gen();
+        uint64_t high = (uint64_t) gen() << 32;
+        return high | (uint64_t) gen();
+    };
+    unsigned __int128 m = (unsigned __int128) draw() * range;
+    auto low = (uint64_t) m;
+    if (low < range) {
+        uint64_t threshold = (0 - range) % range;
+        while (low < threshold) {
+            m = (unsigned __int128) draw() * range;
+            low = (uint64_t) m;
+        }
+    }
+    return (uint64_t) (m >> 64);
+}
+
+// Engine of the calling thread used by knuth_shuffle and RandomQueue, seeded from std::random_device.
+inline Xoshiro256StarStar& defaultRandomEngine() {
+    thread_local Xoshiro256StarStar engine(((uint64_t) std::random_device()() << 32) | std::random_device()());
+    return engine;
+}
+
+// Reseeds the engine of the calling thread, which makes the following shuffles reproducible.
+inline void seedDefaultRandomEngine(uint64_t seed) {
+    defaultRandomEngine() = Xoshiro256StarStar(seed);
+}
+
+void testFastRandom() {
+    std::cout << "Test fast random engines.\n";
+    Xoshiro256StarStar xoshiro(42);
+    Pcg32 pcg(42);
+    auto x1 = xoshiro(), x2 = xoshiro();
+    auto p1 = pcg(), p2 = pcg();
+    std::cout << "xoshiro256**: " << x1 << " " << x2 << ", pcg32: " << p1 << " " << p2 << "\n";
+
+    // Every value of a small range is drawn about equally often.
+    std::vector<long> counts(6, 0);
+    for (int i = 0; i < 600000; i++) counts[bounded_random(xoshiro, 6)]++;
+    long min_count = 600000, max_count = 0;
+    for (auto c : counts) {
+        min_count = std::min(min_count, c);
+        max_count = std::max(max_count, c);
+    }
+    std::cout << "Bounded random counts within 1% of 100000: " << (min_count > 99000 && max_count < 101000) << "\n";
+
+    Xoshiro256StarStar a(7), b(7);
+    b.jump();
+    std::cout << "Jumped engine gives a different stream: " << (a() != b()) << "\n";
+}
+
+#endif //ALGS_FAST_RANDOM_H
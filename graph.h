@@ -12,6 +12,7 @@
 #include <sstream>
 #include <stack>
 #include <queue>
+#include "mapped_file.h"
 
 class Graph {
 public:
@@ -25,20 +26,20 @@ public:
     }
 
     Graph(std::string file_name) {
-        std::fstream f(file_name, std::fstream::in);
-        if (!f) {
+        PairFileReader reader(file_name);
+        if (!reader.isOpen()) {
             std::cerr << "Error opening file.\n";
             return;
         }
 
-        f >> vertex_count;
+        reader.readCount(vertex_count);
 
         for (int i = 0; i < vertex_count; i++) {
             adjacency_list.push_back(vertexEdgeList());
         }
 
         int i, j;
-        while (f >> i >> j) {
+        while (reader.readPair(i, j)) {
             addEdge(i, j);
         }
     }
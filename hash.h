@@ -0,0 +1,251 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_HASH_H
+#define ALGS_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <functional>
+#include <type_traits>
+
+/**
+ * Hash functions and bucket reductions for the hash tables.
+ *
+ * std::hash of an integer is the integer itself and std::hash of a string is not built for short keys, so the
+ * tables hash through FastHash instead: integers go through mix64, a finalizer in which every input bit flips
+ * every output bit with probability close to 1/2, and strings through hashBytes, in the style of wyhash, which
+ * consumes 16 bytes per 64 x 64 -> 128 bit multiplication. Any other key is hashed by std::hash and mixed.
+ *
+ * A hash is turned into a bucket with a multiplication and a shift instead of a division: reduceRange for any
+ * bucket count, fibonacciBucket for a power of two. Both read the high bits of the hash, which is why the hash
+ * has to be mixed first.
+ */
+
+// Splitmix64's finalizer.
+inline uint64_t mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Full product of a and b, its low half in a and its high half in b.
+inline void multiplyWide(uint64_t& a, uint64_t& b) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = (unsigned __int128) a * b;
+    a = (uint64_t) product;
+    b = (uint64_t) (product >> 64);
+#else
+    uint64_t a_high = a >> 32, a_low = (uint32_t) a, b_high = b >> 32, b_low = (uint32_t) b;
+    uint64_t high = a_high * b_high, middle0 = a_high * b_low, middle1 = a_low * b_high, low = a_low * b_low;
+    uint64_t t = low + (middle0 << 32);
+    uint64_t carry = t < low;
+    uint64_t low_half = t + (middle1 << 32);
+    carry += low_half < t;
+    b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+    a = low_half;
+#endif
+}
+
+// Xor of the two halves of the full product, which depends on every bit of both operands.
+inline uint64_t multiplyFold(uint64_t a, uint64_t b) {
+    multiplyWide(a, b);
+    return a ^ b;
+}
+
+namespace hash_detail {
+    const uint64_t secret[4] = {0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+                                0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL};
+
+    inline uint64_t read8(const unsigned char* p) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+    inline uint64_t read4(const unsigned char* p) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    // First, middle and last of 1 to 3 bytes.
+    inline uint64_t read3(const unsigned char* p, size_t length) {
+        return ((uint64_t) p[0] << 16) | ((uint64_t) p[length >> 1] << 8) | p[length - 1];
+    }
+}
+
+// Hash of length bytes. Keys of up to 16 bytes take two multiplications, longer ones one more per 16 bytes.
+inline uint64_t hashBytes(const void* data, size_t length, uint64_t seed = 0) {
+    using namespace hash_detail;
+    auto p = (const unsigned char*) data;
+    seed ^= multiplyFold(seed ^ secret[0], secret[1]);
+    uint64_t a, b;
+    if (length <= 16) {
+        if (length >= 4) {
+            // Two overlapping pairs of 4 byte reads cover 4 to 16 bytes.
+            size_t offset = (length >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + offset);
+            b = (read4(p + length - 4) << 32) | read4(p + length - 4 - offset);
+        }
+        else if (length > 0) {
+            a = read3(p, length);
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        size_t left = length;
+        if (left > 48) {
+            // Three independent lanes, so that their multiplications overlap.
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = multiplyFold(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                seed1 = multiplyFold(read8(p + 16) ^ secret[2], read8(p + 24) ^ seed1);
+                seed2 = multiplyFold(read8(p + 32) ^ secret[3], read8(p + 40) ^ seed2);
+                p += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (left > 16) {
+            seed = multiplyFold(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+            p += 16;
+            left -= 16;
+        }
+        // The last 16 bytes, which may overlap the ones already consumed.
+        a = read8(p + left - 16);
+        b = read8(p + left - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    multiplyWide(a, b);
+    return multiplyFold(a ^ secret[0] ^ length, b ^ secret[1]);
+}
+
+/**
+ * Hash functor for the hash tables, see above. Specialize it, or pass another functor to the tables, for keys
+ * whose std::hash is slow or weak.
+ */
+template <typename Key, typename Enable = void>
+struct FastHash {
+    size_t operator()(const Key& key) const {
+        return (size_t) mix64((uint64_t) std::hash<Key>()(key));
+    }
+};
+
+template <typename Key>
+struct FastHash<Key, typename std::enable_if<std::is_integral<Key>::value || std::is_enum<Key>::value>::type> {
+    size_t operator()(Key key) const {
+        return (size_t) mix64((uint64_t) key);
+    }
+};
+
+template <>
+struct FastHash<std::string> {
+    size_t operator()(const std::string& key) const {
+        return (size_t) hashBytes(key.data(), key.size());
+    }
+};
+
+// Maps a hash to [0, n) from its high bits, with one multiplication instead of a division (Lemire's fastrange).
+inline size_t reduceRange(uint64_t hash, size_t n) {
+    uint64_t high = n;
+    multiplyWide(hash, high);
+    return (size_t) high;
+}
+
+// Maps a hash to [0, 2^bits) from the top bits of its product with 2^64 / golden ratio (Fibonacci hashing).
+// The multiplication moves the low bits up too, so it is also fine for hashes that only vary in their low bits.
+inline size_t fibonacciBucket(uint64_t hash, int bits) {
+    return bits == 0 ? 0 : (size_t) ((hash * 0x9e3779b97f4a7c15ULL) >> (64 - bits));
+}
+
+// Largest deviation from 1/2 over all (input bit, output bit) pairs of the probability that flipping the input
+// bit flips the output bit, for random inputs of the given byte length. 0 for a perfect avalanche.
+template <typename Hash>
+double worstAvalancheBias(Hash hash, size_t length, int samples, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<int> flips(length * 8 * 64);
+    std::vector<unsigned char> input(length);
+    for (int s = 0; s < samples; s++) {
+        for (auto& byte : input) byte = (unsigned char) gen();
+        uint64_t original = hash(input.data(), length);
+        for (size_t bit = 0; bit < length * 8; bit++) {
+            input[bit / 8] ^= (unsigned char) (1 << (bit % 8));
+            uint64_t changed = original ^ hash(input.data(), length);
+            input[bit / 8] ^= (unsigned char) (1 << (bit % 8));
+            for (int out = 0; out < 64; out++) flips[bit * 64 + out] += (changed >> out) & 1;
+        }
+    }
+    double worst = 0;
+    for (auto f : flips) worst = std::max(worst, std::fabs((double) f / samples - 0.5));
+    return worst;
+}
+
+// Chi-square statistic of the bucket counts of the hashes against a uniform distribution. For a good hash it
+// is close to buckets - 1, give or take sqrt(2 (buckets - 1)).
+inline double bucketChiSquare(const std::vector<size_t>& bucket_of_key, size_t buckets) {
+    std::vector<size_t> counts(buckets);
+    for (auto b : bucket_of_key) counts[b]++;
+    double expected = (double) bucket_of_key.size() / buckets, chi_square = 0;
+    for (auto c : counts) chi_square += (c - expected) * (c - expected) / expected;
+    return chi_square;
+}
+
+void testHash() {
+    std::cout << "Test hash functions.\n";
+    const int samples = 2000;
+    auto mixed = [](const unsigned char* p, size_t) {
+        uint64_t x;
+        std::memcpy(&x, p, 8);
+        return mix64(x);
+    };
+    auto identity = [](const unsigned char* p, size_t) {
+        uint64_t x;
+        std::memcpy(&x, p, 8);
+        return (uint64_t) std::hash<uint64_t>()(x);
+    };
+    auto bytes = [](const unsigned char* p, size_t length) { return hashBytes(p, length); };
+    // Within 5 standard deviations of 1/2 for every one of the 4096 to 32768 pairs, the largest of that many
+    // deviations of a perfect hash is around 4.
+    double limit = 5 * 0.5 / std::sqrt((double) samples);
+    double mix_bias = worstAvalancheBias(mixed, 8, samples, 1);
+    double std_bias = worstAvalancheBias(identity, 8, samples, 1);
+    std::cout << "Worst avalanche bias of mix64 below " << limit << ": " << (mix_bias < limit)
+              << ", of std::hash<uint64_t>: " << std_bias << "\n";
+    bool bytes_avalanche = true;
+    for (size_t length : {3, 8, 13, 16, 40, 64}) {
+        bytes_avalanche &= worstAvalancheBias(bytes, length, samples, length) < limit;
+    }
+    std::cout << "Worst avalanche bias of hashBytes below it for 3 to 64 bytes: " << bytes_avalanche << "\n";
+
+    // Consecutive integers and similar strings, the keys that trip weak hashes up.
+    const size_t keys = 1 << 16, buckets = 1 << 10, bits = 10;
+    double tolerance = 6 * std::sqrt(2.0 * (buckets - 1));
+    std::vector<size_t> range(keys), fibonacci(keys), strings(keys), modulo_identity(keys);
+    for (size_t i = 0; i < keys; i++) {
+        auto name = "key" + std::to_string(i);
+        range[i] = reduceRange(FastHash<size_t>()(i * 1024), buckets);
+        fibonacci[i] = fibonacciBucket(FastHash<size_t>()(i * 1024), bits);
+        strings[i] = reduceRange(FastHash<std::string>()(name), buckets);
+        modulo_identity[i] = std::hash<size_t>()(i * 1024) % buckets;
+    }
+    bool uniform = std::fabs(bucketChiSquare(range, buckets) - (buckets - 1)) < tolerance
+                   && std::fabs(bucketChiSquare(fibonacci, buckets) - (buckets - 1)) < tolerance
+                   && std::fabs(bucketChiSquare(strings, buckets) - (buckets - 1)) < tolerance;
+    std::cout << "Bucket chi-square of multiples of 1024 and of \"key<i>\" strings within " << tolerance
+              << " of " << buckets - 1 << ": " << uniform << ", with std::hash and modulo: "
+              << bucketChiSquare(modulo_identity, buckets) << "\n";
+}
+
+#endif //ALGS_HASH_H
@@ -5,17 +5,31 @@
 #ifndef ALGS_HASH_TABLE_H
 #define ALGS_HASH_TABLE_H
 
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <cassert>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <random>
+#include <map>
+#include "hash.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 class Person {
 public:
     Person() {}
     Person(std::string first, std::string last) : first_name(first), last_name(last) {}
 
+    // The hash of the first name seeds the one of the last name, so swapping them changes the hash.
     size_t hash() const {
-        size_t hash_code = 17;
-        std::hash<std::string> string_hash_fn;
-        hash_code += 31 * hash_code + string_hash_fn(first_name);
-        hash_code += 31 * hash_code + string_hash_fn(last_name);
-        return hash_code;
+        return (size_t) hashBytes(last_name.data(), last_name.size(),
+                                  hashBytes(first_name.data(), first_name.size()));
     }
 
     bool operator==(const Person& other) {
@@ -46,7 +60,8 @@ namespace std {
 
 typedef double Money;
 
-template <typename Key, typename Value>
+// Hash has to mix its output, the bucket comes from its high bits.
+template <typename Key, typename Value, typename Hash = FastHash<Key> >
 class ChainingHashSymbolTable {
     struct LinkedListNode;
     typedef std::shared_ptr<LinkedListNode> NodeP;
@@ -240,7 +255,7 @@ protected:
     }
 
     int hashBucket(Key key) {
-        return (int) ((std::hash<Key>()(key) & 0x07ffffffff) % bucket_count);
+        return (int) reduceRange(hasher(key), (size_t) bucket_count);
     }
 
     NodeP& getBucketNode(int index) { return buckets.get()[index]; }
@@ -254,9 +269,11 @@ private:
     int bucket_count;
     size_t element_count;
     BucketP buckets;
+    Hash hasher;
 };
 
-template <typename Key, typename Value>
+// The capacity is a power of two, so that the probe sequence wraps with a mask. Hash has to mix its output.
+template <typename Key, typename Value, typename Hash = FastHash<Key> >
 class LinearProbingHashSymbolTable {
     typedef std::shared_ptr<Key> KeyArrayP;
     typedef std::shared_ptr<Value> ValueArrayP;
@@ -269,14 +286,16 @@ public:
 public:
     LinearProbingHashSymbolTable() : LinearProbingHashSymbolTable(default_capacity) {}
 
-    LinearProbingHashSymbolTable(size_t _capacity) : capacity(_capacity) {
+    // Rounded up to a power of two.
+    LinearProbingHashSymbolTable(size_t _capacity) :
+            capacity_bits(bitsFor(_capacity)), capacity(1UL << capacity_bits) {
         auto p = booleans.get();
         std::uninitialized_fill(p, p + capacity, false);
     }
 
     MaybeValue get(Key key) {
         auto i = hashCode(key);
-        for (; getBool(i) != false; i = (i + 1) % capacity) {
+        for (; getBool(i) != false; i = (i + 1) & (capacity - 1)) {
             if (getKey(i) == key) {
                 return std::make_pair(getValue(i), true);
             }
@@ -288,7 +307,7 @@ public:
         if (element_count >= capacity / 2) resize(capacity * 2);
 
         auto i = hashCode(key);
-        for (; getBool(i) != false; i = (i + 1) % capacity) {
+        for (; getBool(i) != false; i = (i + 1) & (capacity - 1)) {
             if (getKey(i) == key) {
                 getValue(i) = value;
                 return;
@@ -306,21 +325,21 @@ public:
         if (!contains(key)) return;
 
         auto i = hashCode(key);
-        for (; getBool(i) != false; i = (i + 1) % capacity) {
+        for (; getBool(i) != false; i = (i + 1) & (capacity - 1)) {
             if (getKey(i) == key) {
                 break;
             }
         }
 
         getBool(i) = false;
-        i = (i + 1) % capacity;
+        i = (i + 1) & (capacity - 1);
         while (getBool(i) != false) {
             auto temp_key = getKey(i);
             auto temp_value = getValue(i);
             getBool(i) = false;
             element_count--;
             insert(temp_key, temp_value);
-            i = (i + 1) % capacity;
+            i = (i + 1) & (capacity - 1);
         }
 
         element_count--;
@@ -400,11 +419,18 @@ protected:
         std::swap(keys, new_st.keys);
         std::swap(values, new_st.values);
         std::swap(booleans, new_st.booleans);
-        capacity = new_capacity;
+        capacity_bits = new_st.capacity_bits;
+        capacity = new_st.capacity;
     }
 
     size_t hashCode(Key key) {
-        return ((std::hash<Key>()(key) & 0x07ffffffff) % capacity);
+        return fibonacciBucket(hasher(key), capacity_bits);
+    }
+
+    static int bitsFor(size_t capacity) {
+        int bits = 0;
+        while ((1UL << bits) < capacity) bits++;
+        return bits;
     }
 
     Key& getKey(size_t index) { return keys.get()[index]; }
@@ -412,12 +438,1002 @@ protected:
     bool& getBool(size_t index) { return booleans.get()[index]; }
 
 private:
-    const static size_t default_capacity = 10;
+    const static size_t default_capacity = 16;
+    int capacity_bits;
     size_t capacity;
     size_t element_count = 0;
     KeyArrayP keys = KeyArrayP(new Key[capacity], std::default_delete<Key[]>());
     ValueArrayP values = ValueArrayP(new Value[capacity], std::default_delete<Value[]>());
     BoolArrayP booleans = BoolArrayP(new bool[capacity], std::default_delete<bool[]>());
+    Hash hasher;
+};
+
+/**
+ * Open addressing hash table after Google's Swiss tables.
+ *
+ * Every slot has a control byte: empty, deleted, or the low 7 bits of the hash of its key. The slots are probed
+ * in groups of 16, and one SSE2 comparison of the 16 control bytes of a group with the 7 bits of the hash
+ * gives the few slots whose key is worth comparing, 1 in 128 of the others on average. A lookup stops at the
+ * first group with an empty slot, so the table is kept at most 7/8 full. The capacity is a power of two and
+ * the groups are probed in triangular steps, which visits all of them.
+ *
+ * A removed slot becomes empty again if its group still has an empty slot, as no probe ever went past that
+ * group then. Otherwise it becomes a deleted marker that lookups step over and inserts reuse, until the table
+ * is rehashed.
+ *
+ * Hash has to mix its output, the tag comes from its low 7 bits and the first group from the bits above them.
+ */
+template <typename Key, typename Value, typename Hash = FastHash<Key> >
+class SwissHashSymbolTable {
+    typedef int8_t Control;
+    static const Control empty = -128;
+    static const Control deleted = -2;
+    static const size_t group_size = 16;
+    static const size_t not_found = (size_t) -1;
+
+public:
+    typedef std::pair<Key, bool> MaybeKey;
+    typedef std::pair<Value, bool> MaybeValue;
+
+public:
+    SwissHashSymbolTable() : SwissHashSymbolTable(group_size) {}
+
+    // Rounded up to a power of two of at least 16 slots.
+    SwissHashSymbolTable(size_t _capacity) {
+        size_t rounded = group_size;
+        while (rounded < _capacity) rounded *= 2;
+        allocate(rounded);
+    }
+
+    MaybeValue get(const Key& key) {
+        auto i = find(key, hashOf(key));
+        if (i == not_found) return std::make_pair(Value(), false);
+        return std::make_pair(slots[i].second, true);
+    }
+
+    void insert(const Key& key, const Value& value) {
+        auto hash = hashOf(key);
+        auto i = find(key, hash);
+        if (i != not_found) {
+            slots[i].second = value;
+            return;
+        }
+
+        i = findFirstNonFull(hash);
+        if (growth_left == 0 && control[i] == empty) {
+            // Only drop the deleted markers if they are what fills the table.
+            rehash(element_count + 1 > capacity * 7 / 16 ? capacity * 2 : capacity);
+            i = findFirstNonFull(hash);
+        }
+        if (control[i] == empty) growth_left--;
+        control[i] = tag(hash);
+        slots[i] = std::make_pair(key, value);
+        element_count++;
+    }
+
+    void remove(const Key& key) {
+        auto i = find(key, hashOf(key));
+        if (i == not_found) return;
+
+        if (matchEmpty(i / group_size)) {
+            control[i] = empty;
+            growth_left++;
+        }
+        else {
+            control[i] = deleted;
+        }
+        slots[i] = std::pair<Key, Value>();
+        element_count--;
+
+        if (element_count > 0 && element_count <= capacity / 8 && capacity > group_size) rehash(capacity / 2);
+    }
+
+    bool contains(const Key& key) {
+        return find(key, hashOf(key)) != not_found;
+    }
+
+    size_t size() {
+        return element_count;
+    }
+
+    bool isEmpty() {
+        return size() == 0;
+    }
+
+    typedef std::pair<const Key, Value> value_type;
+
+    class iterator : public std::iterator<std::forward_iterator_tag, value_type> {
+        size_t index;
+        SwissHashSymbolTable& st;
+    public:
+        iterator(size_t _index, SwissHashSymbolTable& _st) : index(_index), st(_st) {
+            while (index < st.capacity && st.control[index] < 0) {
+                ++index;
+            }
+        }
+
+        void increment() {
+            do {
+                ++index;
+            }
+            while (index < st.capacity && st.control[index] < 0);
+        }
+
+        iterator& operator++() {
+            increment();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp(*this);
+            increment();
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const iterator &other) const {
+            return !((*this) == other);
+        }
+
+        value_type operator*() const {
+            return std::make_pair(st.slots[index].first, st.slots[index].second);
+        }
+    };
+
+    iterator begin() {
+        if (isEmpty()) return end();
+        return iterator(0, *this);
+    }
+    iterator end() { return iterator(capacity, *this); }
+
+protected:
+    void allocate(size_t new_capacity) {
+        capacity = new_capacity;
+        control.assign(capacity, (Control) empty);
+        slots.assign(capacity, std::pair<Key, Value>());
+        growth_left = capacity * 7 / 8;
+    }
+
+    void rehash(size_t new_capacity) {
+        std::vector<Control> old_control;
+        std::vector<std::pair<Key, Value> > old_slots;
+        std::swap(old_control, control);
+        std::swap(old_slots, slots);
+        auto old_capacity = capacity;
+        allocate(new_capacity);
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_control[i] < 0) continue;
+            auto hash = hashOf(old_slots[i].first);
+            auto j = findFirstNonFull(hash);
+            control[j] = tag(hash);
+            slots[j] = std::move(old_slots[i]);
+            growth_left--;
+        }
+    }
+
+    size_t hashOf(const Key& key) const {
+        return hasher(key);
+    }
+
+    static Control tag(size_t hash) { return (Control) (hash & 0x7f); }
+
+    size_t firstGroup(size_t hash) { return (hash >> 7) & (capacity / group_size - 1); }
+
+    size_t find(const Key& key, size_t hash) {
+        auto group = firstGroup(hash);
+        for (size_t step = 1; ; step++) {
+            for (auto match = matchByte(group, tag(hash)); match; match &= match - 1) {
+                auto i = group * group_size + __builtin_ctz(match);
+                if (slots[i].first == key) return i;
+            }
+            if (matchEmpty(group)) return not_found;
+            group = (group + step) & (capacity / group_size - 1);
+        }
+    }
+
+    // First empty or deleted slot on the probe sequence of hash, there is always one.
+    size_t findFirstNonFull(size_t hash) {
+        auto group = firstGroup(hash);
+        for (size_t step = 1; ; step++) {
+            auto match = matchEmptyOrDeleted(group);
+            if (match) return group * group_size + __builtin_ctz(match);
+            group = (group + step) & (capacity / group_size - 1);
+        }
+    }
+
+    // Bit i is set if control byte i of the group equals c.
+    unsigned matchByte(size_t group, Control c) {
+#ifdef __SSE2__
+        __m128i bytes = _mm_loadu_si128((const __m128i*) &control[group * group_size]);
+        return (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(c)));
+#else
+        unsigned match = 0;
+        for (size_t i = 0; i < group_size; i++) match |= (unsigned) (control[group * group_size + i] == c) << i;
+        return match;
+#endif
+    }
+
+    unsigned matchEmpty(size_t group) {
+        return matchByte(group, empty);
+    }
+
+    // Empty and deleted are the control bytes with the sign bit set.
+    unsigned matchEmptyOrDeleted(size_t group) {
+#ifdef __SSE2__
+        return (unsigned) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) &control[group * group_size]));
+#else
+        unsigned match = 0;
+        for (size_t i = 0; i < group_size; i++) match |= (unsigned) (control[group * group_size + i] < 0) << i;
+        return match;
+#endif
+    }
+
+private:
+    size_t capacity;
+    size_t element_count = 0;
+    // Empty slots that can still be filled before the table is 7/8 full.
+    size_t growth_left;
+    std::vector<Control> control;
+    std::vector<std::pair<Key, Value> > slots;
+    Hash hasher;
+};
+
+/**
+ * Open addressing hash table with Robin Hood hashing.
+ *
+ * Every slot records how far its key is from its home slot, the slot its hash points at. An insert that probes
+ * past a key closer to its home than the one being inserted takes that slot and carries the poorer key on, so
+ * the displacements stay even instead of growing long runs for a few keys, and their variance stays low up to
+ * high load factors. A lookup stops at the first slot whose key is closer to home than the probe has gone, as
+ * its key would have taken that slot, which also keeps misses short. Removal shifts the keys that follow back
+ * by one slot until one is at home or a slot is empty, so there are no deleted markers.
+ *
+ * Displacements are kept in a byte. The table grows past the max load factor, 0.9 by default, or when a
+ * displacement would not fit, and shrinks when 1/8 full. Hash has to mix its output, the home slot comes from its
+ * low bits.
+ */
+template <typename Key, typename Value, typename Hash = FastHash<Key> >
+class RobinHoodHashSymbolTable {
+    // distances[i] is 0 for an empty slot, 1 + the displacement of its key otherwise.
+    typedef uint8_t Distance;
+    static const Distance max_distance = 255;
+    static const size_t min_capacity = 16;
+    static const size_t not_found = (size_t) -1;
+
+public:
+    typedef std::pair<Key, bool> MaybeKey;
+    typedef std::pair<Value, bool> MaybeValue;
+
+public:
+    RobinHoodHashSymbolTable() : RobinHoodHashSymbolTable(min_capacity) {}
+
+    // Rounded up to a power of two of at least 16 slots.
+    RobinHoodHashSymbolTable(size_t _capacity, double _max_load_factor = 0.9) : max_load_factor(_max_load_factor) {
+        assert(max_load_factor > 0 && max_load_factor < 1);
+        size_t rounded = min_capacity;
+        while (rounded < _capacity) rounded *= 2;
+        allocate(rounded);
+    }
+
+    MaybeValue get(const Key& key) {
+        auto i = find(key);
+        if (i == not_found) return std::make_pair(Value(), false);
+        return std::make_pair(slots[i].second, true);
+    }
+
+    void insert(const Key& key, const Value& value) {
+        auto i = find(key);
+        if (i != not_found) {
+            slots[i].second = value;
+            return;
+        }
+        if (element_count + 1 > max_elements) rehash(capacity * 2);
+        place(std::make_pair(key, value));
+        element_count++;
+    }
+
+    void remove(const Key& key) {
+        auto i = find(key);
+        if (i == not_found) return;
+
+        for (auto next = (i + 1) & mask(); distances[next] > 1; i = next, next = (next + 1) & mask()) {
+            slots[i] = std::move(slots[next]);
+            distances[i] = distances[next] - 1;
+        }
+        distances[i] = 0;
+        slots[i] = std::pair<Key, Value>();
+        element_count--;
+
+        if (element_count > 0 && element_count <= capacity / 8 && capacity > min_capacity) rehash(capacity / 2);
+    }
+
+    bool contains(const Key& key) {
+        return find(key) != not_found;
+    }
+
+    size_t size() {
+        return element_count;
+    }
+
+    bool isEmpty() {
+        return size() == 0;
+    }
+
+    size_t getCapacity() const { return capacity; }
+
+    double loadFactor() const { return (double) element_count / capacity; }
+
+    // Entry i counts the keys found after probing i slots, their displacement + 1.
+    std::vector<size_t> hitProbeLengths() const {
+        std::vector<size_t> histogram;
+        for (size_t i = 0; i < capacity; i++) {
+            if (distances[i] == 0) continue;
+            if (histogram.size() <= distances[i]) histogram.resize(distances[i] + 1);
+            histogram[distances[i]]++;
+        }
+        return histogram;
+    }
+
+    // Entry i counts the home slots from which a missing key is known to be missing after probing i slots.
+    // Every home slot is equally likely for a missing key, so this is the distribution of the cost of a miss.
+    std::vector<size_t> missProbeLengths() const {
+        std::vector<size_t> histogram;
+        for (size_t home = 0; home < capacity; home++) {
+            size_t probes = 1;
+            for (auto i = home; distances[i] >= probes; i = (i + 1) & mask()) probes++;
+            if (histogram.size() <= probes) histogram.resize(probes + 1);
+            histogram[probes]++;
+        }
+        return histogram;
+    }
+
+    typedef std::pair<const Key, Value> value_type;
+
+    class iterator : public std::iterator<std::forward_iterator_tag, value_type> {
+        size_t index;
+        RobinHoodHashSymbolTable& st;
+    public:
+        iterator(size_t _index, RobinHoodHashSymbolTable& _st) : index(_index), st(_st) {
+            while (index < st.capacity && st.distances[index] == 0) {
+                ++index;
+            }
+        }
+
+        void increment() {
+            do {
+                ++index;
+            }
+            while (index < st.capacity && st.distances[index] == 0);
+        }
+
+        iterator& operator++() {
+            increment();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp(*this);
+            increment();
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const iterator &other) const {
+            return !((*this) == other);
+        }
+
+        value_type operator*() const {
+            return std::make_pair(st.slots[index].first, st.slots[index].second);
+        }
+    };
+
+    iterator begin() {
+        if (isEmpty()) return end();
+        return iterator(0, *this);
+    }
+    iterator end() { return iterator(capacity, *this); }
+
+protected:
+    size_t mask() const { return capacity - 1; }
+
+    size_t home(const Key& key) const { return hasher(key) & mask(); }
+
+    void allocate(size_t new_capacity) {
+        capacity = new_capacity;
+        distances.assign(capacity, 0);
+        slots.assign(capacity, std::pair<Key, Value>());
+        // At least one slot stays empty, which ends every probe.
+        max_elements = std::min((size_t) (capacity * max_load_factor), capacity - 1);
+    }
+
+    void rehash(size_t new_capacity) {
+        std::vector<Distance> old_distances;
+        std::vector<std::pair<Key, Value> > old_slots;
+        std::swap(old_distances, distances);
+        std::swap(old_slots, slots);
+        allocate(new_capacity);
+        for (size_t i = 0; i < old_distances.size(); i++) {
+            if (old_distances[i] != 0) place(std::move(old_slots[i]));
+        }
+    }
+
+    // A key closer to its home than the probe has gone would have been displaced by the one looked for.
+    size_t find(const Key& key) {
+        size_t distance = 1;
+        for (auto i = home(key); distances[i] >= distance; i = (i + 1) & mask(), distance++) {
+            if (distances[i] == distance && slots[i].first == key) return i;
+        }
+        return not_found;
+    }
+
+    // Puts a key that is not in the table in the slot where Robin Hood ordering wants it, shifting the richer
+    // keys after it along. There is room for it.
+    void place(std::pair<Key, Value> slot) {
+        size_t distance = 1;
+        for (auto i = home(slot.first); ; i = (i + 1) & mask(), distance++) {
+            if (distance == max_distance) {
+                // Doubling the capacity halves the expected run lengths.
+                rehash(capacity * 2);
+                place(std::move(slot));
+                return;
+            }
+            if (distances[i] == 0) {
+                distances[i] = (Distance) distance;
+                slots[i] = std::move(slot);
+                return;
+            }
+            if (distances[i] < distance) {
+                std::swap(slots[i], slot);
+                auto displaced = distances[i];
+                distances[i] = (Distance) distance;
+                distance = displaced;
+            }
+        }
+    }
+
+private:
+    double max_load_factor = 0.9;
+    size_t capacity;
+    size_t max_elements;
+    size_t element_count = 0;
+    std::vector<Distance> distances;
+    std::vector<std::pair<Key, Value> > slots;
+    Hash hasher;
+};
+
+/**
+ * Array that grows in slabs of 2^SlabBits elements which are never moved, so references to its elements stay
+ * valid, and growing never copies them.
+ */
+template <typename T, size_t SlabBits = 10>
+class SlabArray {
+public:
+    T& operator[](size_t i) { return slabs[i >> SlabBits][i & (slab_size - 1)]; }
+
+    void push_back(const T& value) {
+        if (count == slabs.size() * slab_size) slabs.emplace_back(new T[slab_size]);
+        (*this)[count++] = value;
+    }
+
+    // The slabs are kept for the next push_back.
+    void pop_back() { count--; }
+
+    size_t size() const { return count; }
+
+private:
+    static const size_t slab_size = (size_t) 1 << SlabBits;
+    std::vector<std::unique_ptr<T[]> > slabs;
+    size_t count = 0;
+};
+
+/**
+ * Separate chaining without an allocation per entry. The nodes live in a SlabArray and are linked by 32 bit
+ * indices, removed nodes go to a free list that insert reuses. A node keeps the hash of its key, so that moving
+ * it to another bucket never hashes the key again. References returned by find stay valid until their key is
+ * removed.
+ *
+ * The table grows and shrinks one bucket at a time with linear hashing (Litwin). With 2^k <= bucket count <
+ * 2^(k+1), bucket split holds the keys whose hash modulo 2^(k+1) is split or split + 2^k, buckets below it are
+ * already split. An insert that brings the average chain length over 1 splits bucket split into itself and a new
+ * bucket at the end, so growing costs a few node moves per insert instead of a rehash of the whole table.
+ * Hash has to mix its output, the buckets come from its low 32 bits.
+ */
+template <typename Key, typename Value, typename Hash = FastHash<Key> >
+class PooledChainingHashSymbolTable {
+    typedef uint32_t NodeIndex;
+    static const NodeIndex null_node = (NodeIndex) -1;
+    static const size_t min_bucket_count = 16;
+
+    struct Node {
+        Key key;
+        Value value;
+        uint32_t hash;
+        NodeIndex next;
+    };
+
+public:
+    typedef std::pair<Key, bool> MaybeKey;
+    typedef std::pair<Value, bool> MaybeValue;
+
+public:
+    PooledChainingHashSymbolTable() : PooledChainingHashSymbolTable(min_bucket_count) {}
+
+    // Rounded up to a power of two of at least 16 buckets.
+    PooledChainingHashSymbolTable(size_t _bucket_count) {
+        while (level < _bucket_count) level *= 2;
+        for (size_t i = 0; i < level; i++) heads.push_back(null_node);
+    }
+
+    MaybeValue get(const Key& key) {
+        auto value = find(key);
+        if (value == nullptr) return std::make_pair(Value(), false);
+        return std::make_pair(*value, true);
+    }
+
+    // Address of the value of key, nullptr if there is none. It stays valid until key is removed.
+    Value* find(const Key& key) {
+        auto hash = (uint32_t) hasher(key);
+        for (auto i = heads[bucketOf(hash)]; i != null_node; i = nodes[i].next) {
+            auto& node = nodes[i];
+            if (node.hash == hash && node.key == key) return &node.value;
+        }
+        return nullptr;
+    }
+
+    void insert(const Key& key, const Value& value) {
+        auto hash = (uint32_t) hasher(key);
+        auto& head = heads[bucketOf(hash)];
+        for (auto i = head; i != null_node; i = nodes[i].next) {
+            auto& node = nodes[i];
+            if (node.hash == hash && node.key == key) {
+                node.value = value;
+                return;
+            }
+        }
+
+        NodeIndex i;
+        if (free_list != null_node) {
+            i = free_list;
+            free_list = nodes[i].next;
+        }
+        else {
+            assert(nodes.size() < null_node);
+            i = (NodeIndex) nodes.size();
+            nodes.push_back(Node());
+        }
+        auto& node = nodes[i];
+        node.key = key;
+        node.value = value;
+        node.hash = hash;
+        node.next = head;
+        head = i;
+        element_count++;
+
+        if (element_count > heads.size()) splitBucket();
+    }
+
+    void remove(const Key& key) {
+        auto hash = (uint32_t) hasher(key);
+        for (auto link = &heads[bucketOf(hash)]; *link != null_node; link = &nodes[*link].next) {
+            auto& node = nodes[*link];
+            if (node.hash == hash && node.key == key) {
+                auto i = *link;
+                *link = node.next;
+                node.key = Key();
+                node.value = Value();
+                node.next = free_list;
+                free_list = i;
+                element_count--;
+                if (element_count < heads.size() / 4 && heads.size() > min_bucket_count) mergeBucket();
+                return;
+            }
+        }
+    }
+
+    bool contains(const Key& key) {
+        return find(key) != nullptr;
+    }
+
+    size_t size() {
+        return element_count;
+    }
+
+    bool isEmpty() {
+        return size() == 0;
+    }
+
+    typedef std::pair<const Key, Value> value_type;
+
+    class iterator : public std::iterator<std::forward_iterator_tag, value_type> {
+        size_t bucket;
+        NodeIndex node;
+        PooledChainingHashSymbolTable& st;
+    public:
+        iterator(size_t _bucket, PooledChainingHashSymbolTable& _st) : bucket(_bucket), node(null_node), st(_st) {
+            if (bucket < st.heads.size()) node = st.heads[bucket];
+            skipEmptyBuckets();
+        }
+
+        void increment() {
+            node = st.nodes[node].next;
+            skipEmptyBuckets();
+        }
+
+        iterator& operator++() {
+            increment();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp(*this);
+            increment();
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const {
+            return bucket == other.bucket && node == other.node;
+        }
+
+        bool operator!=(const iterator &other) const {
+            return !((*this) == other);
+        }
+
+        value_type operator*() const {
+            return std::make_pair(st.nodes[node].key, st.nodes[node].value);
+        }
+
+    private:
+        void skipEmptyBuckets() {
+            while (node == null_node && bucket < st.heads.size()) {
+                if (++bucket < st.heads.size()) node = st.heads[bucket];
+            }
+        }
+    };
+
+    iterator begin() {
+        if (isEmpty()) return end();
+        return iterator(0, *this);
+    }
+    iterator end() { return iterator(heads.size(), *this); }
+
+protected:
+    size_t bucketOf(uint32_t hash) {
+        size_t bucket = hash & (level - 1);
+        if (bucket < split) bucket = hash & (2 * level - 1);
+        return bucket;
+    }
+
+    // Moves the nodes of bucket split whose hash has the bit of level set to a new bucket split + level.
+    void splitBucket() {
+        heads.push_back(null_node);
+        auto i = heads[split];
+        NodeIndex* keep = &heads[split];
+        NodeIndex* move = &heads[split + level];
+        for (; i != null_node; i = nodes[i].next) {
+            auto& link = nodes[i].hash & level ? move : keep;
+            *link = i;
+            link = &nodes[i].next;
+        }
+        *keep = null_node;
+        *move = null_node;
+        if (++split == level) {
+            level *= 2;
+            split = 0;
+        }
+    }
+
+    // Undoes the last split, appending the last bucket to the one it was split from.
+    void mergeBucket() {
+        if (split == 0) {
+            level /= 2;
+            split = level;
+        }
+        split--;
+        auto link = &heads[split];
+        while (*link != null_node) link = &nodes[*link].next;
+        *link = heads[split + level];
+        heads.pop_back();
+    }
+
+private:
+    SlabArray<NodeIndex> heads;
+    SlabArray<Node> nodes;
+    NodeIndex free_list = null_node;
+    size_t element_count = 0;
+    // Buckets split + level and above do not exist yet, level is a power of two.
+    size_t level = min_bucket_count;
+    size_t split = 0;
+    Hash hasher;
+};
+
+template <typename Key, typename Value, typename Hash>
+const typename PooledChainingHashSymbolTable<Key, Value, Hash>::NodeIndex
+        PooledChainingHashSymbolTable<Key, Value, Hash>::null_node;
+
+/**
+ * Hash table for many threads inserting, removing and looking up at once.
+ *
+ * The keys are spread over independent segments by the top bits of their hash. Writers of a segment take its
+ * mutex, readers take no lock: a segment has a version that a writer makes odd while it modifies the segment
+ * and even again when done, and a reader retries if the version was odd or changed while it probed (a seqlock).
+ * Lookups in different segments, or in the same one while nobody writes to it, never wait nor write to shared
+ * memory.
+ *
+ * As readers may probe a segment while it is modified, its slots are atomics, loaded and stored relaxed, so the
+ * keys and values have to be trivially copyable, e.g. integers, ids and pointers. A segment is an open
+ * addressing table with linear probing, kept at most half full. Removed slots are deleted markers until the
+ * segment fills up, then they are purged in place within one write, readers retry meanwhile.
+ *
+ * Growing a segment publishes an array of twice the capacity and keeps the old one, where readers may still be,
+ * until the table is destroyed. Segments do not shrink, so the kept arrays add up to less than the current ones
+ * and the memory at most doubles, however many keys come and go.
+ *
+ * Hash has to mix its output, the segment comes from its top bits and the slot from its low bits.
+ */
+template <typename Key, typename Value, typename Hash = FastHash<Key> >
+class ConcurrentHashSymbolTable {
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                  "Keys and values of ConcurrentHashSymbolTable have to be trivially copyable.");
+
+    enum SlotState : uint8_t { Empty, Full, Deleted };
+
+    struct Slots {
+        explicit Slots(size_t _capacity) :
+                capacity(_capacity),
+                states(new std::atomic<uint8_t>[capacity]),
+                keys(new std::atomic<Key>[capacity]),
+                values(new std::atomic<Value>[capacity]) {
+            for (size_t i = 0; i < capacity; i++) states[i].store(Empty, std::memory_order_relaxed);
+        }
+
+        size_t capacity;
+        std::unique_ptr<std::atomic<uint8_t>[]> states;
+        std::unique_ptr<std::atomic<Key>[]> keys;
+        std::unique_ptr<std::atomic<Value>[]> values;
+    };
+
+    struct Segment {
+        std::mutex mutex;
+        std::atomic<uint64_t> version;
+        std::atomic<Slots*> slots;
+        // Full and deleted slots of the current array, only used by writers.
+        size_t used = 0;
+        std::atomic<size_t> count;
+        std::vector<std::unique_ptr<Slots> > arrays;
+        // Keys and values of the segment while its deleted markers are purged, only used by writers.
+        std::vector<std::pair<Key, Value> > purge_buffer;
+        // Keeps the mutexes and versions of neighbor segments off each other's cache lines.
+        char padding[64];
+    };
+
+public:
+    typedef std::pair<Key, bool> MaybeKey;
+    typedef std::pair<Value, bool> MaybeValue;
+
+public:
+    // The segment count is rounded up to a power of two, more segments make writers wait on each other less.
+    explicit ConcurrentHashSymbolTable(size_t _segment_count = 64) {
+        while (segment_count < _segment_count) {
+            segment_count *= 2;
+            segment_bits++;
+        }
+        segments.reset(new Segment[segment_count]);
+        for (size_t i = 0; i < segment_count; i++) {
+            auto& segment = segments[i];
+            segment.version.store(0, std::memory_order_relaxed);
+            segment.count.store(0, std::memory_order_relaxed);
+            segment.arrays.emplace_back(new Slots(min_segment_capacity));
+            segment.slots.store(segment.arrays.back().get(), std::memory_order_release);
+        }
+    }
+
+    MaybeValue get(const Key& key) {
+        auto hash = hasher(key);
+        auto& segment = segmentOf(hash);
+        while (true) {
+            auto version = segment.version.load(std::memory_order_acquire);
+            if (version & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            auto slots = segment.slots.load(std::memory_order_acquire);
+            auto i = find(*slots, key, hash);
+            Value value = i == not_found ? Value() : slots->values[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (segment.version.load(std::memory_order_relaxed) == version) {
+                return std::make_pair(value, i != not_found);
+            }
+        }
+    }
+
+    void insert(const Key& key, const Value& value) {
+        auto hash = hasher(key);
+        auto& segment = segmentOf(hash);
+        std::lock_guard<std::mutex> lock(segment.mutex);
+        auto slots = segment.slots.load(std::memory_order_relaxed);
+        auto i = find(*slots, key, hash);
+        if (i != not_found) {
+            beginWrite(segment);
+            slots->values[i].store(value, std::memory_order_relaxed);
+            endWrite(segment);
+            return;
+        }
+
+        if (segment.used + 1 > slots->capacity / 2) {
+            // Only drop the deleted markers if they are what fills the segment.
+            if (segment.count.load(std::memory_order_relaxed) + 1 > slots->capacity / 4) slots = grow(segment);
+            else purge(segment);
+        }
+        i = hash & (slots->capacity - 1);
+        while (slots->states[i].load(std::memory_order_relaxed) == Full) i = (i + 1) & (slots->capacity - 1);
+
+        beginWrite(segment);
+        if (slots->states[i].load(std::memory_order_relaxed) == Empty) segment.used++;
+        slots->keys[i].store(key, std::memory_order_relaxed);
+        slots->values[i].store(value, std::memory_order_relaxed);
+        slots->states[i].store(Full, std::memory_order_relaxed);
+        segment.count.store(segment.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        endWrite(segment);
+    }
+
+    void remove(const Key& key) {
+        auto hash = hasher(key);
+        auto& segment = segmentOf(hash);
+        std::lock_guard<std::mutex> lock(segment.mutex);
+        auto slots = segment.slots.load(std::memory_order_relaxed);
+        auto i = find(*slots, key, hash);
+        if (i == not_found) return;
+
+        beginWrite(segment);
+        slots->states[i].store(Deleted, std::memory_order_relaxed);
+        segment.count.store(segment.count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        endWrite(segment);
+    }
+
+    bool contains(const Key& key) {
+        return get(key).second;
+    }
+
+    // Exact once all updates have returned.
+    size_t size() {
+        size_t total = 0;
+        for (size_t i = 0; i < segment_count; i++) total += segments[i].count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    bool isEmpty() {
+        return size() == 0;
+    }
+
+    // Arrays allocated by all segments, the current ones included. Call it while no thread writes.
+    size_t arrayCount() {
+        size_t total = 0;
+        for (size_t i = 0; i < segment_count; i++) total += segments[i].arrays.size();
+        return total;
+    }
+
+protected:
+    static const size_t not_found = (size_t) -1;
+    static const size_t min_segment_capacity = 16;
+
+    Segment& segmentOf(size_t hash) {
+        return segments[segment_bits ? (uint64_t) hash >> (64 - segment_bits) : 0];
+    }
+
+    // Stops after capacity slots, which only happens when a reader sees a segment in the middle of a write.
+    static size_t find(const Slots& slots, const Key& key, size_t hash) {
+        auto mask = slots.capacity - 1;
+        for (size_t i = hash & mask, probes = 0; probes < slots.capacity; i = (i + 1) & mask, probes++) {
+            auto state = slots.states[i].load(std::memory_order_relaxed);
+            if (state == Empty) return not_found;
+            if (state == Full && slots.keys[i].load(std::memory_order_relaxed) == key) return i;
+        }
+        return not_found;
+    }
+
+    // The version is odd from before the first store of a write to after the last one.
+    static void beginWrite(Segment& segment) {
+        segment.version.store(segment.version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    static void endWrite(Segment& segment) {
+        segment.version.store(segment.version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Stores a key that is not in the slots into the first free slot of its probe sequence.
+    void place(Slots& slots, const Key& key, const Value& value) {
+        auto j = hasher(key) & (slots.capacity - 1);
+        while (slots.states[j].load(std::memory_order_relaxed) != Empty) j = (j + 1) & (slots.capacity - 1);
+        slots.keys[j].store(key, std::memory_order_relaxed);
+        slots.values[j].store(value, std::memory_order_relaxed);
+        slots.states[j].store(Full, std::memory_order_relaxed);
+    }
+
+    // Copies the full slots to an array of twice the capacity, which only becomes visible to readers once
+    // complete. The old array is kept for the readers that may still probe it.
+    Slots* grow(Segment& segment) {
+        auto old_slots = segment.slots.load(std::memory_order_relaxed);
+        std::unique_ptr<Slots> slots(new Slots(old_slots->capacity * 2));
+        for (size_t i = 0; i < old_slots->capacity; i++) {
+            if (old_slots->states[i].load(std::memory_order_relaxed) != Full) continue;
+            place(*slots, old_slots->keys[i].load(std::memory_order_relaxed),
+                  old_slots->values[i].load(std::memory_order_relaxed));
+        }
+        segment.used = segment.count.load(std::memory_order_relaxed);
+
+        beginWrite(segment);
+        segment.slots.store(slots.get(), std::memory_order_release);
+        endWrite(segment);
+        segment.arrays.push_back(std::move(slots));
+        return segment.arrays.back().get();
+    }
+
+    // Drops the deleted markers by reinserting the keys into the same array, as one write.
+    void purge(Segment& segment) {
+        auto slots = segment.slots.load(std::memory_order_relaxed);
+        auto& live = segment.purge_buffer;
+        live.clear();
+        for (size_t i = 0; i < slots->capacity; i++) {
+            if (slots->states[i].load(std::memory_order_relaxed) != Full) continue;
+            live.push_back(std::make_pair(slots->keys[i].load(std::memory_order_relaxed),
+                                          slots->values[i].load(std::memory_order_relaxed)));
+        }
+
+        beginWrite(segment);
+        for (size_t i = 0; i < slots->capacity; i++) slots->states[i].store(Empty, std::memory_order_relaxed);
+        for (auto& entry : live) place(*slots, entry.first, entry.second);
+        endWrite(segment);
+        segment.used = live.size();
+    }
+
+private:
+    size_t segment_count = 1;
+    int segment_bits = 0;
+    std::unique_ptr<Segment[]> segments;
+    Hash hasher;
+};
+
+// Makes any symbol table safe to share between threads by serializing every operation behind one mutex.
+template <typename Key, typename Value, template <class, class, class...> class Impl = SwissHashSymbolTable>
+class LockedHashSymbolTable {
+public:
+    typedef typename Impl<Key, Value>::MaybeValue MaybeValue;
+
+    MaybeValue get(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return st.get(key);
+    }
+
+    void insert(const Key& key, const Value& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        st.insert(key, value);
+    }
+
+    void remove(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        st.remove(key);
+    }
+
+    bool contains(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return st.contains(key);
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return st.size();
+    }
+
+private:
+    Impl<Key, Value> st;
+    std::mutex mutex;
 };
 
 template <typename Key, typename Value>
@@ -429,7 +1445,7 @@ void printHashMaybeValue(typename ChainingHashSymbolTable<Key, Value>::MaybeValu
     }
 }
 
-template <template <class, class> class HashTable>
+template <template <class, class, class...> class HashTable>
 void testHashTableImpl(std::string impl_name) {
     std::cout << "Test hash table - " << impl_name << ".\n";
     HashTable<Person, Money> chain_st;
@@ -476,9 +1492,118 @@ void testHashTableImpl(std::string impl_name) {
 
 };
 
+// Random inserts and removals at 95% load checked against a std::map, then the probe lengths at that load.
+void testRobinHoodHighLoad() {
+    std::cout << "Test robin hood hashing at high load.\n";
+    const size_t capacity = 1 << 16;
+    RobinHoodHashSymbolTable<int, int> st(capacity, 0.95);
+    std::map<int, int> expected;
+    std::mt19937 gen(7);
+    bool matches = true;
+    while (expected.size() < capacity * 95 / 100) {
+        int key = (int) (gen() % (4 * capacity));
+        if (gen() % 4 == 0) {
+            st.remove(key);
+            expected.erase(key);
+        }
+        else {
+            st.insert(key, key + 1);
+            expected[key] = key + 1;
+        }
+        int probe = (int) (gen() % (4 * capacity));
+        auto it = expected.find(probe);
+        auto value = st.get(probe);
+        matches &= value.second == (it != expected.end()) && (!value.second || value.first == it->second);
+    }
+    matches &= st.size() == expected.size() && st.getCapacity() == capacity;
+    std::cout << "Updates at load " << st.loadFactor() << " match a std::map: " << matches << "\n";
+
+    auto average = [](const std::vector<size_t>& histogram) {
+        size_t count = 0, total = 0;
+        for (size_t i = 0; i < histogram.size(); i++) count += histogram[i], total += i * histogram[i];
+        return (double) total / count;
+    };
+    auto hits = st.hitProbeLengths(), misses = st.missProbeLengths();
+    std::cout << "Probes per hit: " << average(hits) << " on average, " << hits.size() - 1
+              << " at most. Probes per miss: " << average(misses) << " on average, " << misses.size() - 1
+              << " at most.\n";
+}
+
+// Threads insert and remove their own keys while others read, values are derived from the keys so a reader can
+// tell a torn or stale value. The final contents have to be those of a sequential run.
+template <typename HashTable>
+bool testConcurrentHashTableImpl(int threads) {
+    const int keys_per_thread = 20000;
+    HashTable st;
+    std::atomic<bool> done(false), consistent(true);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&st, t]() {
+            for (int i = 0; i < keys_per_thread; i++) {
+                int key = i * 64 + t;
+                st.insert(key, 3 * key);
+                if (i % 3 == 0) st.remove(key);
+            }
+        });
+    }
+    std::thread reader([&]() {
+        std::mt19937 gen(5);
+        while (!done.load()) {
+            int key = (int) (gen() % (keys_per_thread * 64));
+            auto value = st.get(key);
+            if (value.second && value.first != 3 * key) consistent = false;
+        }
+    });
+    for (auto& w : workers) w.join();
+    done = true;
+    reader.join();
+
+    bool same = consistent && st.size() == (size_t) threads * (keys_per_thread - (keys_per_thread + 2) / 3);
+    for (int t = 0; t < threads; t++) {
+        for (int i = 0; i < keys_per_thread; i++) {
+            int key = i * 64 + t;
+            auto value = st.get(key);
+            same &= value.second == (i % 3 != 0) && (!value.second || value.first == 3 * key);
+        }
+    }
+    return same;
+}
+
+// Keys inserted and removed over and over around a fixed set of live keys. The segments only need purging, their
+// arrays must not multiply.
+bool testConcurrentHashTableChurn() {
+    const size_t segments = 64;
+    ConcurrentHashSymbolTable<int, int> st(segments);
+    for (int key = 0; key < 1000; key++) st.insert(key, key);
+    auto churn = [&st](int round) {
+        for (int key = 1000 + round * 2000; key < 3000 + round * 2000; key++) st.insert(key, key);
+        for (int key = 1000 + round * 2000; key < 3000 + round * 2000; key++) st.remove(key);
+    };
+    // The first rounds grow the segments to hold up to 3000 keys, the following ones mostly purge them. A segment
+    // may still grow once for a round that puts more keys in it than before, while every purge used to allocate.
+    for (int round = 0; round < 10; round++) churn(round);
+    auto arrays = st.arrayCount();
+    for (int round = 10; round < 200; round++) churn(round);
+    bool live = st.size() == 1000;
+    for (int key = 0; key < 1000; key++) live &= st.get(key) == std::make_pair(key, true);
+    return live && st.arrayCount() <= arrays + segments;
+}
+
 void testHashTable() {
     testHashTableImpl<ChainingHashSymbolTable>("separate chaining");
     testHashTableImpl<LinearProbingHashSymbolTable>("linear probing");
+    testHashTableImpl<SwissHashSymbolTable>("swiss table");
+    testHashTableImpl<PooledChainingHashSymbolTable>("pooled chaining");
+    testHashTableImpl<RobinHoodHashSymbolTable>("robin hood");
+    testRobinHoodHighLoad();
+
+    std::cout << "Test concurrent hash table.\n";
+    std::cout << "Updates from 4 threads with a concurrent reader match a sequential run: "
+              << testConcurrentHashTableImpl<ConcurrentHashSymbolTable<int, int> >(4) << "\n";
+    std::cout << "Insert and remove churn keeps the arrays of the concurrent hash table: "
+              << testConcurrentHashTableChurn() << "\n";
+    std::cout << "Same for a mutex wrapped swiss table: "
+              << testConcurrentHashTableImpl<LockedHashSymbolTable<int, int> >(4) << "\n";
 }
 
 #endif //ALGS_HASH_TABLE_H
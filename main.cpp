@@ -7,14 +7,25 @@
 #include "priority_queue.h"
 #include "bst.h"
 #include "llrb.h"
+#include "hash.h"
 #include "hash_table.h"
 #include "threads.h"
 #include "applications/percolation.h"
+#include "applications/dynamic_connectivity.h"
 #include "simple_deque.h"
 #include "random_queue.h"
 #include "graph.h"
 #include "digraph.h"
 #include "maximum_path_sum.h"
+#include "thread_pool.h"
+#include "parallel_sorts.h"
+#include "pdq_sort.h"
+#include "radix_sort.h"
+#include "sorting_networks.h"
+#include "external_sort.h"
+#include "fast_random.h"
+#include "mapped_file.h"
+#include "successor_set.h"
 
 int main() {
     testUF();
@@ -27,13 +38,24 @@ int main() {
     testPriorityQueue();
     testBST();
     testLLRB();
+    testHash();
     testHashTable();
     testThreads();
-    PercolationStats(50, 100);
+    testPercolation();
+    testDynamicConnectivity();
     testDeque();
     testRandomQueue();
     testGraph();
     testDiGraph();
     testMaximumPathSum();
+    testThreadPool();
+    testParallelSorts();
+    testPdqSort();
+    testRadixSort();
+    testSortingNetworks();
+    testExternalSort();
+    testFastRandom();
+    testMappedFile();
+    testSuccessorSet();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,283 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_MAPPED_FILE_H
+#define ALGS_MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Read only memory mapping of a whole file. The pages are read in by the kernel as they are touched, without
+ * copying them through a stream buffer.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& file_name) {
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            length = (size_t) st.st_size;
+            if (length == 0) {
+                opened = true;
+            }
+            else {
+                void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    address = (const char*) p;
+                    opened = true;
+                    madvise(p, length, MADV_SEQUENTIAL);
+                }
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (address) munmap((void*) address, length);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    const char* begin() const { return address; }
+    const char* end() const { return address + (address ? length : 0); }
+    size_t size() const { return length; }
+
+private:
+    const char* address = nullptr;
+    size_t length = 0;
+    bool opened = false;
+};
+
+/**
+ * Parses whitespace separated decimal integers out of a character range.
+ *
+ * Digits are converted 8 at a time: one 64 bit load finds how many of the next 8 bytes are digits with a few
+ * bytewise operations, and three multiplications combine them into a number (SWAR, SIMD within a register).
+ * The bytes near the end of the range are parsed one at a time, so that the loads never read past it.
+ *
+ * next parses one number, and where each number starts depends on where the previous one ended. nextMany
+ * first classifies 64 bytes at a time into digit and whitespace bitmasks with SSE2, which gives the start and
+ * length of every number of the block at once, so their conversions do not wait on each other.
+ */
+class IntegerParser {
+public:
+    IntegerParser(const char* first, const char* last) : current(first), end(last) {}
+
+    // Parses the next integer, with an optional leading minus sign. Returns false at the end of the input or if
+    // the next token is not a number.
+    template <typename Int>
+    bool next(Int& value) {
+        while (current != end && (unsigned char) *current <= ' ') ++current;
+        if (current == end) return false;
+        bool negative = *current == '-';
+        if (negative) ++current;
+        auto digits = current;
+        uint64_t magnitude = parseDigits();
+        if (current == digits) return false;
+        value = negative ? (Int) (0 - magnitude) : (Int) magnitude;
+        return true;
+    }
+
+    // Parses up to max_count integers into out, like calling next max_count times. Returns how many were parsed.
+    template <typename Int>
+    size_t nextMany(Int* out, size_t max_count) {
+        size_t count = 0;
+#if defined(__SSE2__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // The 8 byte loads of the last numbers of a block reach 8 bytes past it.
+        while (count < max_count && end - current >= 64 + 8) {
+            uint64_t digits, spaces;
+            classifyBlock(current, digits, spaces);
+            // Signs and other bytes are left to next.
+            if (~(digits | spaces)) break;
+
+            // Bit i of starts is set if a number starts at byte i, bit i of ends if byte i is past its end.
+            uint64_t starts = digits & ~(digits << 1);
+            uint64_t ends = ~digits & (digits << 1);
+            // current is never in the middle of a number, so a digit at byte 0 starts one.
+            size_t consumed = 64;
+            // Starts and ends alternate, the i-th end belongs to the i-th start.
+            while (starts) {
+                auto start = (unsigned) __builtin_ctzll(starts);
+                // The number may continue into the next block.
+                if (!ends || count == max_count) {
+                    consumed = start;
+                    break;
+                }
+                auto length = (unsigned) __builtin_ctzll(ends) - start;
+                ends &= ends - 1;
+                const char* digit = current + start;
+                if (length <= 8) {
+                    uint64_t chunk;
+                    std::memcpy(&chunk, digit, 8);
+                    out[count++] = (Int) eightDigits((chunk ^ 0x3030303030303030ULL) << (8 * (8 - length)));
+                }
+                else {
+                    uint64_t value = 0;
+                    for (unsigned i = 0; i < length; i++) value = value * 10 + (unsigned) (digit[i] - '0');
+                    out[count++] = (Int) value;
+                }
+                starts &= starts - 1;
+            }
+            current += consumed;
+            // A single number longer than the block, next handles it.
+            if (consumed == 0 && count < max_count) break;
+        }
+#endif
+        while (count < max_count && next(out[count])) count++;
+        return count;
+    }
+
+    bool atEnd() const { return current == end; }
+
+private:
+#ifdef __SSE2__
+    // Bit i of digits is set if p[i] is a digit, bit i of spaces if it is whitespace or a control character.
+    static void classifyBlock(const char* p, uint64_t& digits, uint64_t& spaces) {
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i space = _mm_set1_epi8(' ');
+        digits = 0;
+        spaces = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i bytes = _mm_loadu_si128((const __m128i*) (p + 16 * i));
+            __m128i offsets = _mm_sub_epi8(bytes, zero);
+            __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(offsets, nine), offsets);
+            __m128i is_space = _mm_cmpeq_epi8(_mm_min_epu8(bytes, space), bytes);
+            digits |= (uint64_t) (unsigned) _mm_movemask_epi8(is_digit) << (16 * i);
+            spaces |= (uint64_t) (unsigned) _mm_movemask_epi8(is_space) << (16 * i);
+        }
+    }
+#endif
+
+    uint64_t parseDigits() {
+        uint64_t result = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        static const uint64_t powers_of_10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+        while (end - current >= 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, current, 8);
+            // Digits become bytes 0 to 9, every other byte has a bit set in its high nibble, either already or
+            // once 6 is added to its low nibble. Neither step carries into the next byte.
+            uint64_t t = chunk ^ 0x3030303030303030ULL;
+            uint64_t high = (t | ((t & 0x0f0f0f0f0f0f0f0fULL) + 0x0606060606060606ULL)) & 0xf0f0f0f0f0f0f0f0ULL;
+            // High bit of every byte that is not a digit.
+            uint64_t non_digits = (((high & 0x7f7f7f7f7f7f7f7fULL) + 0x7f7f7f7f7f7f7f7fULL) | high)
+                                  & 0x8080808080808080ULL;
+            unsigned length = non_digits ? (unsigned) __builtin_ctzll(non_digits) / 8 : 8;
+            if (length == 0) return result;
+            // The first byte holds the most significant digit. Shifting the digits to the top leaves zero bytes,
+            // leading zeros, below them.
+            result = result * powers_of_10[length] + eightDigits(t << (8 * (8 - length)));
+            current += length;
+            if (length < 8) return result;
+        }
+#endif
+        while (current != end && (unsigned) (*current - '0') < 10) {
+            result = result * 10 + (unsigned) (*current - '0');
+            ++current;
+        }
+        return result;
+    }
+
+    // Value of 8 digit bytes 0 to 9, the lowest byte being the most significant digit.
+    static uint64_t eightDigits(uint64_t t) {
+        t = (t * 2561) >> 8;
+        t = ((t & 0x00ff00ff00ff00ffULL) * 6553601) >> 16;
+        return ((t & 0x0000ffff0000ffffULL) * 42949672960001ULL) >> 32;
+    }
+
+    const char* current;
+    const char* end;
+};
+
+/**
+ * Reads the files of data/ that start with a count followed by pairs of integers, like data/mediumUF.txt and
+ * data/tinyGraph.txt, from a memory mapping.
+ */
+class PairFileReader {
+public:
+    explicit PairFileReader(const std::string& file_name) : file(file_name), parser(file.begin(), file.end()) {}
+
+    bool isOpen() const { return file.isOpen(); }
+
+    size_t size() const { return file.size(); }
+
+    template <typename Int>
+    bool readCount(Int& n) {
+        return parser.next(n);
+    }
+
+    template <typename Int>
+    bool readPair(Int& a, Int& b) {
+        return parser.next(a) && parser.next(b);
+    }
+
+    // Parses up to max_count pairs into out. Returns how many were parsed, 0 once the pairs are exhausted.
+    template <typename Int>
+    size_t readPairs(std::pair<Int, Int>* out, size_t max_count) {
+        const size_t chunk = 256;
+        Int values[2 * chunk];
+        size_t count = 0;
+        while (count < max_count) {
+            auto wanted = std::min(chunk, max_count - count);
+            auto parsed = parser.nextMany(values, 2 * wanted);
+            for (size_t i = 0; i + 1 < parsed; i += 2) out[count++] = std::make_pair(values[i], values[i + 1]);
+            if (parsed < 2 * wanted) break;
+        }
+        return count;
+    }
+
+    // Calls visit(pairs, count) for consecutive batches of the remaining pairs.
+    template <typename Int, typename Visit>
+    void forEachBatch(Visit visit, size_t batch_size = 4096) {
+        std::vector<std::pair<Int, Int> > batch(batch_size);
+        size_t count;
+        while ((count = readPairs(batch.data(), batch_size)) > 0) {
+            visit(batch.data(), count);
+        }
+    }
+
+private:
+    MappedFile file;
+    IntegerParser parser;
+};
+
+void testMappedFile() {
+    std::cout << "Test integer parser.\n";
+    std::string text = " 7 -42 123456789 12345678 1234567812345678 9\r\n00000000001 x";
+    IntegerParser parser(text.data(), text.data() + text.size());
+    long value;
+    while (parser.next(value)) std::cout << value << " ";
+    std::cout << "\n";
+
+    PairFileReader reader("data/tinyUF.txt");
+    if (!reader.isOpen()) {
+        std::cerr << "Error opening file.\n";
+        return;
+    }
+    unsigned long n, pairs = 0;
+    reader.readCount(n);
+    reader.forEachBatch<unsigned long>([&pairs](std::pair<unsigned long, unsigned long>*, size_t count) {
+        pairs += count;
+    }, 4);
+    std::cout << "tinyUF: " << n << " elements, " << pairs << " pairs\n";
+}
+
+#endif //ALGS_MAPPED_FILE_H
@@ -0,0 +1,438 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_PARALLEL_SORTS_H
+#define ALGS_PARALLEL_SORTS_H
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <limits>
+#include <cstdint>
+#include "sorts.h"
+#include "thread_pool.h"
+#include "fast_random.h"
+
+/**
+ * Number of elements taken from a, when the first k elements of the stable merge of a and b are taken. The
+ * remaining k - i elements come from b.
+ *
+ * Binary search over the split (i, k - i), also known as co-ranking or merge path. Ties are resolved in favor
+ * of a, which keeps the merge stable.
+ */
+template <typename It1, typename It2, typename Compare>
+long merge_co_rank(long k, It1 a, long na, It2 b, long nb, Compare comp) {
+    long lo = std::max(0L, k - nb);
+    long hi = std::min(k, na);
+    while (lo < hi) {
+        long i = lo + (hi - lo) / 2;
+        long j = k - i;
+        // a[i] is not greater than b[j - 1], so it has to be part of the first k elements.
+        if (j > 0 && i < na && !comp(*(b + (j - 1)), *(a + i))) {
+            lo = i + 1;
+        }
+        else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Merges pairs of adjacent sorted runs of src into dst. Run r spans [bounds[r], bounds[r + 1]).
+ *
+ * Each pair merge is further cut into pieces of the output with merge_co_rank, so that even the last round,
+ * which merges just two runs, keeps every thread of the pool busy.
+ */
+template <typename SrcIt, typename DstIt, typename Compare>
+void parallel_merge_round(ThreadPool& pool, SrcIt src, DstIt dst, const std::vector<long>& bounds, size_t width,
+                          Compare comp) {
+    auto runs = bounds.size() - 1;
+    auto pairs = (runs + 2 * width - 1) / (2 * width);
+    auto pieces_per_pair = std::max((size_t) 1, pool.size() / pairs);
+
+    std::vector<std::future<void> > futures;
+    for (size_t r = 0; r < runs; r += 2 * width) {
+        long lo = bounds[r];
+        long mid = bounds[std::min(r + width, runs)];
+        long hi = bounds[std::min(r + 2 * width, runs)];
+        long na = mid - lo, nb = hi - mid;
+        auto pieces = std::min(pieces_per_pair, (size_t) std::max(1L, (hi - lo) / 4096));
+
+        for (size_t p = 0; p < pieces; p++) {
+            long k0 = (hi - lo) * p / pieces;
+            long k1 = (hi - lo) * (p + 1) / pieces;
+            futures.push_back(pool.submit([=]() {
+                auto a = src + lo, b = src + mid;
+                long i0 = merge_co_rank(k0, a, na, b, nb, comp);
+                long i1 = merge_co_rank(k1, a, na, b, nb, comp);
+                merge_move(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), dst + (lo + k0), comp);
+            }));
+        }
+    }
+    waitAll(futures);
+}
+
+/**
+ * Stable parallel merge sort.
+ *
+ * The range is cut into one leaf per thread (rounded up to a power of two), leaves are sorted in parallel and
+ * then merged pairwise in log(leaves) parallel rounds. Rounds alternate between the range and a single
+ * auxiliary buffer, so elements are only copied back once at the end, and only if the number of rounds is odd.
+ */
+template <typename RandomIt, typename Compare>
+void parallel_merge_sort(RandomIt first, RandomIt last, ThreadPool& pool, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    long n = std::distance(first, last);
+    const long min_leaf_size = 1 << 13;
+
+    size_t leaves = 1;
+    while (leaves < pool.size() && n / (long) (leaves * 2) >= min_leaf_size) leaves *= 2;
+
+    std::vector<T> buffer(first, last);
+    if (leaves == 1) {
+        merge_sort_with_scratch(first, last, buffer.begin(), comp);
+        return;
+    }
+
+    std::vector<long> bounds;
+    for (size_t i = 0; i <= leaves; i++) {
+        bounds.push_back(n * (long) i / (long) leaves);
+    }
+
+    std::vector<std::future<void> > futures;
+    for (size_t i = 0; i < leaves; i++) {
+        long lo = bounds[i], hi = bounds[i + 1];
+        auto buffer_first = buffer.begin() + lo;
+        futures.push_back(pool.submit([first, lo, hi, buffer_first, comp]() {
+            merge_sort_with_scratch(first + lo, first + hi, buffer_first, comp);
+        }));
+    }
+    waitAll(futures);
+
+    bool in_buffer = false;
+    for (size_t width = 1; width < leaves; width *= 2) {
+        if (in_buffer) parallel_merge_round(pool, buffer.begin(), first, bounds, width, comp);
+        else           parallel_merge_round(pool, first, buffer.begin(), bounds, width, comp);
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        auto source = buffer.begin();
+        parallelFor(pool, (size_t) n, [source, first](size_t lo, size_t hi) {
+            std::move(source + lo, source + hi, first + lo);
+        });
+    }
+    assert(std::is_sorted(first, last, comp));
+}
+
+template <typename RandomIt>
+void parallel_merge_sort(RandomIt first, RandomIt last, ThreadPool& pool) {
+    parallel_merge_sort(first, last, pool, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+template <typename RandomIt>
+void parallel_merge_sort(RandomIt first, RandomIt last) {
+    parallel_merge_sort(first, last, ThreadPool::defaultPool());
+}
+
+// Inputs below this size are sorted sequentially, the sampling and scatter passes do not pay off for them.
+const long sample_sort_min_size = 1 << 16;
+const size_t sample_sort_buckets_per_thread = 8;
+// Bucket ids are stored in a byte, splitter j delimits buckets 2j and 2j + 2.
+const size_t sample_sort_max_splitters = 127;
+// Sample elements drawn per splitter, more make the bucket sizes more even.
+const size_t sample_sort_oversampling = 32;
+
+/**
+ * Parallel sample sort, for inputs much larger than the last level cache. Not stable.
+ *
+ * Splitters are picked from a sorted random sample. Each thread then classifies a contiguous block of the input,
+ * storing the bucket of every element and counting the bucket sizes of its block. From the per block histograms
+ * every block knows where its part of each bucket goes, so a single scatter pass moves all elements into a
+ * buffer, and the buckets are then sorted in parallel with intro_sort and moved back.
+ *
+ * Elements equal to a splitter get a bucket of their own that needs no sorting, so inputs with few distinct keys
+ * do not end up in a single huge bucket.
+ *
+ * The buffer of trivial types is allocated without being initialized and every bucket is first written by a
+ * task of the pool, so that on NUMA machines its pages are placed on the node of a thread that sorts it rather
+ * than all on the node of the calling thread. Pool threads are not pinned to nodes, so this is best effort.
+ */
+template <typename RandomIt, typename Compare>
+void parallel_sample_sort(RandomIt first, RandomIt last, ThreadPool& pool, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    long n = std::distance(first, last);
+    if (pool.size() == 1 || n < sample_sort_min_size) {
+        intro_sort(first, last, comp);
+        return;
+    }
+
+    size_t wanted = std::min(sample_sort_max_splitters, pool.size() * sample_sort_buckets_per_thread - 1);
+    std::mt19937_64 gen((unsigned long) n);
+    std::uniform_int_distribution<long> position(0, n - 1);
+    std::vector<T> sample;
+    for (size_t i = 0; i < (wanted + 1) * sample_sort_oversampling; i++) {
+        sample.push_back(*(first + position(gen)));
+    }
+    intro_sort(sample.begin(), sample.end(), comp);
+    std::vector<T> splitters;
+    for (size_t i = 1; i <= wanted; i++) {
+        auto& s = sample[i * sample_sort_oversampling];
+        if (splitters.empty() || comp(splitters.back(), s)) splitters.push_back(s);
+    }
+    size_t buckets = 2 * splitters.size() + 1;
+
+    // Bucket 2j holds the elements between splitters j - 1 and j, bucket 2j + 1 the elements equal to splitter j.
+    auto classify = [&splitters, &comp](const T& x) {
+        size_t j = std::upper_bound(splitters.begin(), splitters.end(), x, comp) - splitters.begin();
+        if (j > 0 && !comp(splitters[j - 1], x)) return (unsigned char) (2 * j - 1);
+        return (unsigned char) (2 * j);
+    };
+
+    size_t blocks = pool.size();
+    std::vector<long> bounds;
+    for (size_t b = 0; b <= blocks; b++) bounds.push_back(n * (long) b / (long) blocks);
+    std::unique_ptr<unsigned char[]> ids(new unsigned char[n]);
+    std::vector<std::vector<long> > counts(blocks, std::vector<long>(buckets, 0));
+
+    std::vector<std::future<void> > futures;
+    for (size_t b = 0; b < blocks; b++) {
+        futures.push_back(pool.submit([&, b]() {
+            auto& count = counts[b];
+            for (long i = bounds[b]; i < bounds[b + 1]; i++) {
+                auto id = classify(*(first + i));
+                ids[i] = id;
+                count[id]++;
+            }
+        }));
+    }
+    waitAll(futures);
+
+    // Buckets are laid out one after the other, inside a bucket the parts of the blocks follow the block order.
+    std::vector<long> bucket_bounds(buckets + 1, 0);
+    std::vector<std::vector<long> > offsets(blocks, std::vector<long>(buckets));
+    long sum = 0;
+    for (size_t k = 0; k < buckets; k++) {
+        bucket_bounds[k] = sum;
+        for (size_t b = 0; b < blocks; b++) {
+            offsets[b][k] = sum;
+            sum += counts[b][k];
+        }
+    }
+    bucket_bounds[buckets] = sum;
+
+    // new T[n] leaves trivial types uninitialized, so the allocation itself does not touch any page.
+    std::unique_ptr<T[]> buffer(new T[n]);
+    auto buffer_first = buffer.get();
+    if (std::is_trivial<T>::value) {
+        futures.clear();
+        for (size_t k = 0; k < buckets; k++) {
+            futures.push_back(pool.submit([&, k]() {
+                std::fill(buffer_first + bucket_bounds[k], buffer_first + bucket_bounds[k + 1], T());
+            }));
+        }
+        waitAll(futures);
+    }
+
+    futures.clear();
+    for (size_t b = 0; b < blocks; b++) {
+        futures.push_back(pool.submit([&, b]() {
+            auto& offset = offsets[b];
+            for (long i = bounds[b]; i < bounds[b + 1]; i++) {
+                buffer_first[offset[ids[i]]++] = std::move(*(first + i));
+            }
+        }));
+    }
+    waitAll(futures);
+
+    futures.clear();
+    for (size_t k = 0; k < buckets; k++) {
+        futures.push_back(pool.submit([&, k]() {
+            auto bucket_first = buffer_first + bucket_bounds[k], bucket_last = buffer_first + bucket_bounds[k + 1];
+            if (k % 2 == 0) intro_sort(bucket_first, bucket_last, comp);
+            std::move(bucket_first, bucket_last, first + bucket_bounds[k]);
+        }));
+    }
+    waitAll(futures);
+    assert(std::is_sorted(first, last, comp));
+}
+
+template <typename RandomIt>
+void parallel_sample_sort(RandomIt first, RandomIt last, ThreadPool& pool) {
+    parallel_sample_sort(first, last, pool, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+template <typename RandomIt>
+void parallel_sample_sort(RandomIt first, RandomIt last) {
+    parallel_sample_sort(first, last, ThreadPool::defaultPool());
+}
+
+// Swaps a and b if swap is set, without branching on it.
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value>::type conditional_swap(T& a, T& b, bool swap) {
+    T difference = (a ^ b) & (T) -(T) swap;
+    a ^= difference;
+    b ^= difference;
+}
+
+template <typename T>
+typename std::enable_if<!std::is_integral<T>::value>::type conditional_swap(T& a, T& b, bool swap) {
+    if (swap) std::swap(a, b);
+}
+
+/**
+ * Merge step of MergeShuffle (Bacher, Bodini, Hollender and Lumbroso): given the uniformly shuffled halves
+ * [first, mid) and [mid, last), produces a uniform shuffle of [first, last) in place.
+ *
+ * A coin flip per position decides whether it keeps the next element of the first half or swaps in the next
+ * element of the second half. Once a half runs out, the remaining elements are inserted at uniform positions
+ * like in Fisher-Yates.
+ */
+template <typename RandomIt, typename Engine>
+void merge_shuffle_merge(RandomIt first, RandomIt mid, RandomIt last, Engine& gen) {
+    auto i = first, j = mid;
+    uint64_t bits = 0;
+    int bits_left = 0;
+    // While both halves have elements left no flip can end the loop, and for integral elements the swap is
+    // done with a mask instead of a branch that mispredicts on every other flip.
+    while (i < j && j < last) {
+        if (bits_left == 0) {
+            bits = gen();
+            bits_left = std::numeric_limits<typename Engine::result_type>::digits;
+        }
+        bool from_second = bits & 1;
+        bits >>= 1;
+        bits_left--;
+        conditional_swap(*i, *j, from_second);
+        j += from_second;
+        ++i;
+    }
+    while (true) {
+        if (bits_left == 0) {
+            bits = gen();
+            bits_left = std::numeric_limits<typename Engine::result_type>::digits;
+        }
+        bool from_second = bits & 1;
+        bits >>= 1;
+        bits_left--;
+        if (from_second) {
+            if (j == last) break;
+            std::swap(*i, *j);
+            ++j;
+        }
+        else if (i == j) {
+            break;
+        }
+        ++i;
+    }
+    for (; i != last; ++i) {
+        auto r = bounded_random(gen, (uint64_t) std::distance(first, i) + 1);
+        std::swap(*i, *(first + r));
+    }
+}
+
+// Blocks of about this size are shuffled with Fisher-Yates, which is fastest while a block fits in the cache.
+const long parallel_shuffle_block_size = 1 << 16;
+const size_t parallel_shuffle_max_blocks = 1024;
+
+/**
+ * Parallel MergeShuffle. The range is cut into a power of two number of blocks that are shuffled in parallel,
+ * then neighbouring blocks are merged pairwise with merge_shuffle_merge in log(blocks) parallel rounds.
+ *
+ * Every block and every merge draws from its own xoshiro256** stream, derived from seed by jumping, and the
+ * block count only depends on the size of the range. The result is therefore the same for a given seed
+ * whatever the number of threads.
+ */
+template <typename RandomIt>
+void parallel_shuffle(RandomIt first, RandomIt last, ThreadPool& pool, uint64_t seed) {
+    long n = std::distance(first, last);
+    size_t blocks = 1;
+    while (blocks < parallel_shuffle_max_blocks && n / (long) (blocks * 2) >= parallel_shuffle_block_size) blocks *= 2;
+
+    // Stream k is the seeded engine jumped k times.
+    std::vector<Xoshiro256StarStar> streams(2 * blocks - 1, Xoshiro256StarStar(seed));
+    for (size_t k = 1; k < streams.size(); k++) {
+        streams[k] = streams[k - 1];
+        streams[k].jump();
+    }
+
+    std::vector<std::future<void> > futures;
+    for (size_t b = 0; b < blocks; b++) {
+        long lo = n * (long) b / (long) blocks, hi = n * (long) (b + 1) / (long) blocks;
+        auto gen = &streams[b];
+        futures.push_back(pool.submit([first, lo, hi, gen]() { knuth_shuffle(first + lo, first + hi, *gen); }));
+    }
+    waitAll(futures);
+
+    size_t stream = blocks;
+    for (size_t width = 1; width < blocks; width *= 2) {
+        futures.clear();
+        for (size_t b = 0; b < blocks; b += 2 * width) {
+            long lo = n * (long) b / (long) blocks;
+            long mid = n * (long) (b + width) / (long) blocks;
+            long hi = n * (long) (b + 2 * width) / (long) blocks;
+            auto gen = &streams[stream++];
+            futures.push_back(pool.submit([first, lo, mid, hi, gen]() {
+                merge_shuffle_merge(first + lo, first + mid, first + hi, *gen);
+            }));
+        }
+        waitAll(futures);
+    }
+}
+
+template <typename RandomIt>
+void parallel_shuffle(RandomIt first, RandomIt last) {
+    parallel_shuffle(first, last, ThreadPool::defaultPool(), defaultRandomEngine()());
+}
+
+void testParallelSorts() {
+    std::cout << "Test parallel merge sort.\n";
+    std::vector<int> elements = { 4, 2, 9, 6, 7, 3, 8, 1, 5};
+    ThreadPool pool(4);
+    parallel_merge_sort(elements.begin(), elements.end(), pool);
+    print_range(elements.begin(), elements.end());
+
+    // Sort pairs by key only, equal keys have to keep the order of their second component.
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> dist(0, 100);
+    std::vector<std::pair<int, int> > pairs;
+    for (int i = 0; i < 200000; i++) {
+        pairs.push_back(std::make_pair(dist(gen), i));
+    }
+    parallel_merge_sort(pairs.begin(), pairs.end(), pool, [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first < b.first;
+    });
+    std::cout << "Sorted 200000 pairs, stable: " << std::is_sorted(pairs.begin(), pairs.end()) << "\n";
+
+    std::cout << "Test parallel sample sort.\n";
+    std::vector<int> ints(300000);
+    for (auto& i : ints) i = dist(gen) * 100000 + dist(gen);
+    parallel_sample_sort(ints.begin(), ints.end(), pool);
+    std::cout << "Sorted 300000 ints: " << std::is_sorted(ints.begin(), ints.end()) << "\n";
+
+    std::vector<std::string> words(100000);
+    for (auto& w : words) w = std::to_string(dist(gen) % 7);
+    parallel_sample_sort(words.begin(), words.end(), pool);
+    std::cout << "Sorted 100000 strings with 7 distinct values: " << std::is_sorted(words.begin(), words.end()) << "\n";
+
+    std::cout << "Test parallel shuffle.\n";
+    std::vector<int> permutation(1 << 20);
+    for (size_t i = 0; i < permutation.size(); i++) permutation[i] = (int) i;
+    auto shuffled = permutation;
+    parallel_shuffle(shuffled.begin(), shuffled.end(), pool, 42);
+    ThreadPool single(1);
+    auto shuffled_single = permutation;
+    parallel_shuffle(shuffled_single.begin(), shuffled_single.end(), single, 42);
+    std::cout << "Same permutation on 1 and " << pool.size() << " threads: " << (shuffled == shuffled_single) << "\n";
+    intro_sort(shuffled.begin(), shuffled.end());
+    std::cout << "Shuffle is a permutation: " << (shuffled == permutation) << "\n";
+}
+
+#endif //ALGS_PARALLEL_SORTS_H
@@ -0,0 +1,377 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_PDQ_SORT_H
+#define ALGS_PDQ_SORT_H
+
+#include <vector>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+#include "sorts.h"
+#include "priority_queue.h"
+
+/**
+ * Pattern-defeating quick sort, after Orson Peters' pdqsort, with the block partitioning of BlockQuicksort
+ * (Edelkamp and Weiss).
+ *
+ * Instead of swapping out of place elements as soon as they are found, the block partition first records the
+ * offsets of misplaced elements of a block of 64 elements on each side. The comparison result is added to the
+ * offset count instead of being branched on, so the loop has no data dependent branches, and the recorded
+ * elements are then swapped in bulk.
+ */
+
+const long pdq_insertion_sort_threshold = 24;
+const long pdq_ninther_threshold = 128;
+// Partial insertion sort gives up on a range that needs more element moves than this.
+const long pdq_partial_insertion_sort_limit = 8;
+const long pdq_block_size = 64;
+
+// Block partitioning only pays off when comparisons are cheap and free of side effects, so it is used for
+// arithmetic keys with the default orderings.
+template <typename T, typename Compare>
+struct pdq_use_branchless_partition : std::integral_constant<bool,
+        std::is_arithmetic<T>::value &&
+        (std::is_same<Compare, std::less<T> >::value || std::is_same<Compare, std::greater<T> >::value)> {};
+
+// Insertion sort that relies on *(first - 1) not being greater than any element of the range as a sentinel.
+template <typename RandomIt, typename Compare>
+void pdq_unguarded_insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if (first == last) return;
+    for (auto cur = first + 1; cur != last; ++cur) {
+        auto sift = cur;
+        auto sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do { *sift-- = std::move(*sift_1); }
+            while (comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that gives up once it moved more than pdq_partial_insertion_sort_limit elements. Returns
+// whether the range got sorted, which is cheap to find out for ranges that are already (nearly) sorted.
+template <typename RandomIt, typename Compare>
+bool pdq_partial_insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if (first == last) return true;
+    long moves = 0;
+    for (auto cur = first + 1; cur != last; ++cur) {
+        auto sift = cur;
+        auto sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            T tmp = std::move(*sift);
+            do { *sift-- = std::move(*sift_1); }
+            while (sift != first && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+            moves += cur - sift;
+        }
+        if (moves > pdq_partial_insertion_sort_limit) return false;
+    }
+    return true;
+}
+
+template <typename RandomIt, typename Compare>
+void pdq_sort2(RandomIt a, RandomIt b, Compare comp) {
+    if (comp(*b, *a)) std::iter_swap(a, b);
+}
+
+template <typename RandomIt, typename Compare>
+void pdq_sort3(RandomIt a, RandomIt b, RandomIt c, Compare comp) {
+    pdq_sort2(a, b, comp);
+    pdq_sort2(b, c, comp);
+    pdq_sort2(a, b, comp);
+}
+
+// Swaps num recorded element pairs. When the counts differ a cyclic permutation is used instead of swaps,
+// which needs fewer moves.
+template <typename RandomIt>
+void pdq_swap_offsets(RandomIt first, RandomIt last, unsigned char* offsets_l, unsigned char* offsets_r,
+                      long num, bool use_swaps) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if (use_swaps) {
+        for (long i = 0; i < num; ++i) {
+            std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+        }
+    }
+    else if (num > 0) {
+        RandomIt l = first + offsets_l[0];
+        RandomIt r = last - offsets_r[0];
+        T tmp(std::move(*l));
+        *l = std::move(*r);
+        for (long i = 1; i < num; ++i) {
+            l = first + offsets_l[i]; *r = std::move(*l);
+            r = last - offsets_r[i];  *l = std::move(*r);
+        }
+        *r = std::move(tmp);
+    }
+}
+
+/**
+ * Partitions [first, last) around the pivot *first, elements equal to the pivot go to the right. Returns the
+ * final position of the pivot, and whether the range was already partitioned.
+ */
+template <typename RandomIt, typename Compare>
+std::pair<RandomIt, bool> pdq_partition_right_branchless(RandomIt begin, RandomIt end, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    T pivot(std::move(*begin));
+    RandomIt first = begin;
+    RandomIt last = end;
+
+    // Find the first element not smaller than the pivot, the median of 3 guarantees one exists.
+    while (comp(*++first, pivot));
+    // Only guard the search for the last smaller element if no element was skipped above.
+    if (first - 1 == begin) while (first < last && !comp(*--last, pivot));
+    else                    while (!comp(*--last, pivot));
+
+    bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        std::iter_swap(first, last);
+        ++first;
+
+        unsigned char offsets_l_storage[pdq_block_size];
+        unsigned char offsets_r_storage[pdq_block_size];
+        unsigned char* offsets_l = offsets_l_storage;
+        unsigned char* offsets_r = offsets_r_storage;
+        RandomIt offsets_l_base = first;
+        RandomIt offsets_r_base = last;
+        long num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+        while (first < last) {
+            // Fill whichever offset buffer is empty, splitting the unknown elements if both are.
+            long num_unknown = last - first;
+            long left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            long right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+            long left_count = std::min(left_split, pdq_block_size);
+            for (long i = 0; i < left_count;) {
+                offsets_l[num_l] = (unsigned char) i++;
+                num_l += !comp(*first, pivot);
+                ++first;
+            }
+
+            long right_count = std::min(right_split, pdq_block_size);
+            for (long i = 0; i < right_count;) {
+                offsets_r[num_r] = (unsigned char) ++i;
+                num_r += comp(*--last, pivot);
+            }
+
+            long num = std::min(num_l, num_r);
+            pdq_swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r,
+                             num, num_l == num_r);
+            num_l -= num; num_r -= num;
+            start_l += num; start_r += num;
+            if (num_l == 0) { start_l = 0; offsets_l_base = first; }
+            if (num_r == 0) { start_r = 0; offsets_r_base = last; }
+        }
+
+        // At most one of the buffers still holds offsets, move those elements to the boundary.
+        if (num_l) {
+            offsets_l += start_l;
+            while (num_l--) std::iter_swap(offsets_l_base + offsets_l[num_l], --last);
+            first = last;
+        }
+        if (num_r) {
+            offsets_r += start_r;
+            while (num_r--) std::iter_swap(offsets_r_base - offsets_r[num_r], first), ++first;
+            last = first;
+        }
+    }
+
+    RandomIt pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return std::make_pair(pivot_pos, already_partitioned);
+}
+
+// Same contract as pdq_partition_right_branchless, with the classic branching Hoare loop.
+template <typename RandomIt, typename Compare>
+std::pair<RandomIt, bool> pdq_partition_right(RandomIt begin, RandomIt end, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    T pivot(std::move(*begin));
+    RandomIt first = begin;
+    RandomIt last = end;
+
+    while (comp(*++first, pivot));
+    if (first - 1 == begin) while (first < last && !comp(*--last, pivot));
+    else                    while (!comp(*--last, pivot));
+
+    bool already_partitioned = first >= last;
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot));
+        while (!comp(*--last, pivot));
+    }
+
+    RandomIt pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return std::make_pair(pivot_pos, already_partitioned);
+}
+
+/**
+ * Partitions [first, last) around the pivot *first, with elements equal to the pivot going to the left. Used
+ * when the pivot equals the element before the range, in which case all elements equal to it end up in their
+ * final place and do not have to be looked at again, making inputs with many duplicates linear.
+ */
+template <typename RandomIt, typename Compare>
+RandomIt pdq_partition_left(RandomIt begin, RandomIt end, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    T pivot(std::move(*begin));
+    RandomIt first = begin;
+    RandomIt last = end;
+
+    while (comp(pivot, *--last));
+    if (last + 1 == end) while (first < last && !comp(pivot, *++first));
+    else                 while (!comp(pivot, *++first));
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last));
+        while (!comp(pivot, *++first));
+    }
+
+    RandomIt pivot_pos = last;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pivot_pos;
+}
+
+template <bool Branchless, typename RandomIt, typename Compare>
+void pdq_sort_loop(RandomIt begin, RandomIt end, Compare comp, long bad_allowed, bool leftmost) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    while (true) {
+        long size = end - begin;
+        if (size < pdq_insertion_sort_threshold) {
+            if (leftmost) insertion_sort(begin, end, comp);
+            else          pdq_unguarded_insertion_sort(begin, end, comp);
+            return;
+        }
+
+        // Move the pivot to begin, the ninther on large ranges, median of 3 otherwise.
+        long s2 = size / 2;
+        if (size > pdq_ninther_threshold) {
+            pdq_sort3(begin, begin + s2, end - 1, comp);
+            pdq_sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+            pdq_sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+            pdq_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+            std::iter_swap(begin, begin + s2);
+        }
+        else {
+            pdq_sort3(begin + s2, begin, end - 1, comp);
+        }
+
+        // The element before the range is the pivot of an enclosing partition, so it is not greater than any
+        // element here. If it equals the new pivot, the range holds many duplicates of it.
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = pdq_partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        auto partition = Branchless ? pdq_partition_right_branchless(begin, end, comp)
+                                    : pdq_partition_right(begin, end, comp);
+        RandomIt pivot_pos = partition.first;
+        bool already_partitioned = partition.second;
+
+        long l_size = pivot_pos - begin;
+        long r_size = end - (pivot_pos + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            if (--bad_allowed == 0) {
+                // Too many bad partitions, fall back to heap sort, which leaves reverse comp order.
+                heap_sort(begin, end, [&comp](const T& a, const T& b) { return comp(b, a); });
+                return;
+            }
+
+            // Break up patterns that produced the bad partition by swapping a few elements around.
+            if (l_size >= pdq_insertion_sort_threshold) {
+                std::iter_swap(begin, begin + l_size / 4);
+                std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > pdq_ninther_threshold) {
+                    std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= pdq_insertion_sort_threshold) {
+                std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                std::iter_swap(end - 1, end - r_size / 4);
+                if (r_size > pdq_ninther_threshold) {
+                    std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    std::iter_swap(end - 2, end - (1 + r_size / 4));
+                    std::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        }
+        else if (already_partitioned && pdq_partial_insertion_sort(begin, pivot_pos, comp)
+                                     && pdq_partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            // A well balanced partition that needed no swaps hints at sorted input, check it cheaply.
+            return;
+        }
+
+        pdq_sort_loop<Branchless>(begin, pivot_pos, comp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template <typename RandomIt, typename Compare>
+void pdq_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    long n = std::distance(first, last);
+    if (n < 2) return;
+
+    // Whole range is one ascending or strictly descending run, which is common for real inputs.
+    auto descending_end = first + 1;
+    while (descending_end != last && comp(*descending_end, *(descending_end - 1))) ++descending_end;
+    if (descending_end == last) {
+        std::reverse(first, last);
+        return;
+    }
+    if (descending_end == first + 1 && std::is_sorted(first, last, comp)) return;
+
+    long bad_allowed = (long) std::log2((double) n);
+    pdq_sort_loop<pdq_use_branchless_partition<T, Compare>::value>(first, last, comp, bad_allowed, true);
+    assert(std::is_sorted(first, last, comp));
+}
+
+template <typename RandomIt>
+void pdq_sort(RandomIt first, RandomIt last) {
+    pdq_sort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+void testPdqSort() {
+    std::cout << "Test pattern-defeating quick sort.\n";
+    std::vector<int> elements = {4, 2, 2, 2, 2, 3, 8, 2, 2};
+    pdq_sort(elements.begin(), elements.end());
+    print_range(elements.begin(), elements.end());
+    pdq_sort(elements.begin(), elements.end(), std::greater<int>());
+    print_range(elements.begin(), elements.end());
+
+    std::vector<std::string> words = {"pear", "apple", "fig", "banana", "cherry", "apple"};
+    pdq_sort(words.begin(), words.end());
+    print_range(words.begin(), words.end());
+
+    std::mt19937 gen(5);
+    std::vector<double> doubles(100000);
+    for (auto& d : doubles) d = std::uniform_real_distribution<double>(-1, 1)(gen);
+    pdq_sort(doubles.begin(), doubles.end());
+    std::cout << "100000 random doubles sorted: " << std::is_sorted(doubles.begin(), doubles.end()) << "\n";
+
+    std::vector<int> organ_pipe;
+    for (int i = 0; i < 100000; i++) organ_pipe.push_back(std::min(i, 100000 - i));
+    pdq_sort(organ_pipe.begin(), organ_pipe.end());
+    std::cout << "Organ pipe input sorted: " << std::is_sorted(organ_pipe.begin(), organ_pipe.end()) << "\n";
+}
+
+#endif //ALGS_PDQ_SORT_H
@@ -5,6 +5,14 @@
 #ifndef ALGS_PRIORITY_QUEUE_H
 #define ALGS_PRIORITY_QUEUE_H
 
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+#include "utils.h"
+
 template <typename T, typename Compare = std::less<T> >
 class PriorityQueue {
 public:
@@ -125,6 +133,7 @@ void sink(std::vector<T>& elements, long i, long n, Compare comp) {
 template <typename T, typename Compare = std::less<T> >
 void heap_sort(std::vector<T>& elements, Compare comp) {
     auto n = elements.size();
+    if (n < 2) return;
     auto i = n / 2;
 
     // Make a heap.
@@ -141,7 +150,8 @@ void heap_sort(std::vector<T>& elements, Compare comp) {
         sink(elements, 0, i, comp);
     }
 
-    assert(std::is_sorted(elements.begin(), elements.end(), std::not2(comp)));
+    // Extracting each minimum to the end leaves the elements in reverse comp order.
+    assert(std::is_sorted(elements.begin(), elements.end(), [&comp](const T& a, const T& b) { return comp(b, a); }));
 }
 
 template <typename T>
@@ -167,7 +177,9 @@ void sink(RandomIt i, RandomIt first, RandomIt last, long n, Compare comp) {
 
 template <typename RandomIt, typename Compare>
 void heap_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
     auto n = std::distance(first, last);
+    if (n < 2) return;
     auto i = std::next(first, n / 2 - 1);
 
     // Make a heap.
@@ -185,7 +197,7 @@ void heap_sort(RandomIt first, RandomIt last, Compare comp) {
         sink(first, first, i + 1, std::distance(first, i) + 1, comp);
     }
 
-    assert(std::is_sorted(first, last, std::not2(comp)));
+    assert(std::is_sorted(first, last, [&comp](const T& a, const T& b) { return comp(b, a); }));
 }
 
 template <typename RandomIt>
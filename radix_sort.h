@@ -0,0 +1,241 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_RADIX_SORT_H
+#define ALGS_RADIX_SORT_H
+
+#include <vector>
+#include <string>
+#include <array>
+#include <cstring>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include "sorts.h"
+
+/**
+ * Maps an arithmetic key to an unsigned integer of the same width whose unsigned order matches the key order,
+ * so that radix sort can look at the key bits one byte at a time.
+ */
+template <typename T, typename Enable = void>
+struct RadixKeyTraits;
+
+template <typename T>
+struct RadixKeyTraits<T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type> {
+    typedef T type;
+    static type bits(T value) { return value; }
+};
+
+template <typename T>
+struct RadixKeyTraits<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type> {
+    typedef typename std::make_unsigned<T>::type type;
+    // Flipping the sign bit moves negative numbers below the positive ones, two's complement does the rest.
+    static type bits(T value) { return (type) value ^ ((type) 1 << (sizeof(T) * 8 - 1)); }
+};
+
+template <typename T>
+struct RadixKeyTraits<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only IEEE single and double precision keys are supported.");
+    typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type type;
+    // Positive numbers only need the sign bit set. Negative numbers are stored as sign and magnitude, so all
+    // their bits are flipped to reverse their order. NaNs are not supported.
+    static type bits(T value) {
+        type u;
+        std::memcpy(&u, &value, sizeof(T));
+        const type sign = (type) 1 << (sizeof(T) * 8 - 1);
+        return (u & sign) ? ~u : (u | sign);
+    }
+};
+
+struct RadixIdentity {
+    template <typename T>
+    const T& operator()(const T& value) const { return value; }
+};
+
+// Ranges below this size are sorted with insertion sort, the histogram passes do not pay off for them.
+const long radix_sort_insertion_threshold = 64;
+
+/**
+ * LSD radix sort, ordering elements by the arithmetic key returned by key(element). Stable.
+ *
+ * One pass counts the histograms of all key bytes, then every byte whose elements do not all share the same
+ * value is scattered in one pass, alternating between the range and a single buffer.
+ */
+template <typename RandomIt, typename KeyExtractor>
+void radix_sort(RandomIt first, RandomIt last, KeyExtractor key) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef typename std::decay<typename std::result_of<KeyExtractor(const T&)>::type>::type Key;
+    typedef RadixKeyTraits<Key> Traits;
+    typedef typename Traits::type Bits;
+    const size_t passes = sizeof(Bits);
+
+    long n = std::distance(first, last);
+    if (n < 2) return;
+    if (n < radix_sort_insertion_threshold) {
+        insertion_sort(first, last, [&key](const T& a, const T& b) {
+            return Traits::bits(key(a)) < Traits::bits(key(b));
+        });
+        return;
+    }
+
+    std::vector<std::array<size_t, 256> > counts(passes);
+    for (auto& c : counts) c.fill(0);
+    for (auto it = first; it != last; ++it) {
+        Bits bits = Traits::bits(key(*it));
+        for (size_t p = 0; p < passes; p++) {
+            counts[p][(bits >> (8 * p)) & 0xff]++;
+        }
+    }
+
+    std::vector<T> buffer(first, last);
+    auto buffer_first = buffer.begin();
+    bool in_buffer = false;
+    for (size_t p = 0; p < passes; p++) {
+        auto& count = counts[p];
+        // Every element has the same byte, this pass would not change the order.
+        if (std::find(count.begin(), count.end(), (size_t) n) != count.end()) continue;
+
+        std::array<size_t, 256> offsets;
+        size_t sum = 0;
+        for (size_t b = 0; b < 256; b++) {
+            offsets[b] = sum;
+            sum += count[b];
+        }
+
+        auto shift = 8 * p;
+        if (in_buffer) {
+            for (auto it = buffer_first; it != buffer.end(); ++it) {
+                auto digit = (Traits::bits(key(*it)) >> shift) & 0xff;
+                *(first + offsets[digit]++) = std::move(*it);
+            }
+        }
+        else {
+            for (auto it = first; it != last; ++it) {
+                auto digit = (Traits::bits(key(*it)) >> shift) & 0xff;
+                *(buffer_first + offsets[digit]++) = std::move(*it);
+            }
+        }
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) std::move(buffer.begin(), buffer.end(), first);
+}
+
+template <typename RandomIt>
+void radix_sort(RandomIt first, RandomIt last) {
+    radix_sort(first, last, RadixIdentity());
+    assert(std::is_sorted(first, last));
+}
+
+// Buckets below this size are handed to 3-way quick sort instead of being split further.
+const long string_radix_sort_cutoff = 32;
+
+// Byte of s at depth, shifted by one so that 0 can stand for the end of the string.
+inline size_t string_radix_char_at(const std::string& s, size_t depth) {
+    return depth < s.size() ? (size_t) (unsigned char) s[depth] + 1 : 0;
+}
+
+template <typename RandomIt, typename KeyExtractor>
+void american_flag_sort(RandomIt first, RandomIt last, size_t depth, KeyExtractor& key) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    long n = std::distance(first, last);
+    if (n < string_radix_sort_cutoff) {
+        // All strings of the bucket share their first depth characters, only compare what follows.
+        quick_sort_3_way_recursive(first, last, [depth, &key](const T& a, const T& b) {
+            return key(a).compare(depth, std::string::npos, key(b), depth, std::string::npos);
+        });
+        return;
+    }
+
+    std::array<size_t, 257> counts;
+    counts.fill(0);
+    for (auto it = first; it != last; ++it) {
+        counts[string_radix_char_at(key(*it), depth)]++;
+    }
+
+    std::array<size_t, 257> next, ends;
+    size_t sum = 0;
+    for (size_t b = 0; b < 257; b++) {
+        next[b] = sum;
+        sum += counts[b];
+        ends[b] = sum;
+    }
+
+    // Permute in place: every element gets swapped straight into the next free slot of its bucket.
+    for (size_t b = 0; b < 257; b++) {
+        while (next[b] < ends[b]) {
+            auto c = string_radix_char_at(key(*(first + next[b])), depth);
+            if (c == b) {
+                ++next[b];
+            }
+            else {
+                std::swap(*(first + next[b]), *(first + next[c]));
+                ++next[c];
+            }
+        }
+    }
+
+    // Bucket 0 holds the strings that ended, they are equal and already in place.
+    for (size_t b = 1; b < 257; b++) {
+        auto bucket_first = ends[b] - counts[b];
+        if (counts[b] > 1) {
+            american_flag_sort(first + bucket_first, first + ends[b], depth + 1, key);
+        }
+    }
+}
+
+/**
+ * MSD radix sort for strings, in place (American flag sort). Elements are ordered by the std::string returned
+ * by key(element), compared byte by byte like std::string::compare.
+ */
+template <typename RandomIt, typename KeyExtractor>
+void string_radix_sort(RandomIt first, RandomIt last, KeyExtractor key) {
+    american_flag_sort(first, last, 0, key);
+}
+
+template <typename RandomIt>
+void string_radix_sort(RandomIt first, RandomIt last) {
+    RadixIdentity key;
+    american_flag_sort(first, last, 0, key);
+    assert(std::is_sorted(first, last));
+}
+
+void testRadixSort() {
+    std::cout << "Test LSD radix sort of signed integers.\n";
+    std::vector<int> ints = {4, -2, 9, -600000, 7, 3, 2147483647, -1, 0, 5};
+    radix_sort(ints.begin(), ints.end());
+    print_range(ints.begin(), ints.end());
+
+    std::cout << "Test LSD radix sort of doubles.\n";
+    std::vector<double> doubles = {3.5, -0.25, 1e10, -1e10, 0.0, -3.5, 2.75};
+    radix_sort(doubles.begin(), doubles.end());
+    print_range(doubles.begin(), doubles.end());
+
+    std::mt19937_64 gen(7);
+    std::vector<uint64_t> large(100000);
+    for (auto& v : large) v = gen();
+    radix_sort(large.begin(), large.end());
+    std::cout << "100000 random 64 bit integers sorted: " << std::is_sorted(large.begin(), large.end()) << "\n";
+
+    std::cout << "Test LSD radix sort of points by x coordinate.\n";
+    std::vector<Point2D> points = {Point2D(3, 1), Point2D(-1, 2), Point2D(2, 3), Point2D(-1, 0)};
+    radix_sort(points.begin(), points.end(), [](const Point2D& p) { return p.x; });
+    print_range(points.begin(), points.end());
+
+    std::cout << "Test MSD radix sort of strings.\n";
+    std::vector<std::string> words = {"she", "sells", "sea", "shells", "by", "the", "sea", "shore", "", "s"};
+    string_radix_sort(words.begin(), words.end());
+    print_range(words.begin(), words.end());
+
+    std::vector<std::string> many_words(20000);
+    for (auto& w : many_words) {
+        w = std::string(1 + gen() % 8, 'a');
+        for (auto& c : w) c = (char) ('a' + gen() % 3);
+    }
+    string_radix_sort(many_words.begin(), many_words.end());
+    std::cout << "20000 random strings sorted: " << std::is_sorted(many_words.begin(), many_words.end()) << "\n";
+}
+
+#endif //ALGS_RADIX_SORT_H
@@ -63,9 +63,9 @@ public:
 
         iterator& operator=(const iterator& other) {
             iterator tmp(other);
-            std::swap(elements, other.elements);
-            std::swap(index, other.index);
-            std::swap(element_count, other.element_count);
+            std::swap(elements, tmp.elements);
+            std::swap(index, tmp.index);
+            std::swap(element_count, tmp.element_count);
             return *this;
         }
 
@@ -121,9 +121,7 @@ protected:
     }
 
     size_t getRandomIndex() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        return std::uniform_int_distribution<unsigned long>{0, element_count - 1}(gen);
+        return bounded_random(defaultRandomEngine(), element_count);
     }
 private:
     TP elements = nullptr;
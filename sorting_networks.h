@@ -0,0 +1,416 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_SORTING_NETWORKS_H
+#define ALGS_SORTING_NETWORKS_H
+
+#include <vector>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <random>
+#include <cstring>
+#include <cstdint>
+#include "utils.h"
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define ALGS_HAVE_SORTING_NETWORKS 1
+#endif
+
+/**
+ * Bitonic sorting networks for small ranges of 32 bit ints and floats, used by the comparison sorts as their
+ * base case instead of insertion sort.
+ *
+ * A sorting network performs the same compare-exchange steps whatever the input, so a whole register of pairs
+ * is ordered with one vector min and max and there are no data dependent branches. Ranges are padded to 8, 16
+ * or 32 keys. The kernels are compiled for SSE4.1 and AVX2 and the widest one the CPU supports is picked at run
+ * time, on other CPUs the callers keep using insertion sort.
+ *
+ * Floats are sorted as integers whose order matches theirs, so -0.0 ends up before 0.0 although they compare
+ * equal. A network does not keep equal elements in order either, so the stable sorts go through
+ * stable_sorting_network_sort and stable_sorting_network_merge, which only take ints, whose equal elements are
+ * identical. NaNs are not supported, just like with std::less.
+ */
+
+const long sorting_network_max_size = 32;
+
+enum class SimdLevel { None, SSE41, AVX2 };
+
+inline SimdLevel detectSimdLevel() {
+#ifdef ALGS_HAVE_SORTING_NETWORKS
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+#endif
+    return SimdLevel::None;
+}
+
+// Kernel level used by the sorts. It can be lowered to compare the kernels with each other or with the fallback.
+inline SimdLevel& sortingNetworkLevel() {
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+// Comparators that order elements by their natural <, the only order the kernels implement.
+template <typename Compare, typename T>
+struct is_natural_order : std::false_type {};
+
+template <typename T>
+struct is_natural_order<std::less<T>, T> : std::true_type {};
+
+// Maps elements to signed 32 bit keys whose order matches the element order, and back.
+template <typename T>
+struct NetworkKeys;
+
+template <>
+struct NetworkKeys<int32_t> {
+    static const bool flips_negatives = false;
+    static int32_t encode(int32_t value) { return value; }
+    static int32_t decode(int32_t key) { return key; }
+};
+
+template <>
+struct NetworkKeys<float> {
+    // Negative floats are stored as sign and magnitude, flipping all bits but the sign reverses their order.
+    static const bool flips_negatives = true;
+    static int32_t encode(float value) {
+        int32_t key;
+        std::memcpy(&key, &value, sizeof(key));
+        return key ^ ((key >> 31) & 0x7fffffff);
+    }
+    static float decode(int32_t key) {
+        key ^= (key >> 31) & 0x7fffffff;
+        float value;
+        std::memcpy(&value, &key, sizeof(value));
+        return value;
+    }
+};
+
+// The kernels need contiguous 32 bit elements ordered by their natural <.
+template <typename RandomIt, typename Compare>
+struct sorting_network_applies {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    static const bool value =
+            (std::is_same<T, int32_t>::value || std::is_same<T, float>::value) &&
+            (std::is_pointer<RandomIt>::value || std::is_same<RandomIt, typename std::vector<T>::iterator>::value) &&
+            is_natural_order<Compare, T>::value;
+};
+
+// Elements that compare equal only when they are identical, so that no sort can tell equal ones apart.
+template <typename RandomIt, typename Compare>
+struct stable_sorting_network_applies {
+    static const bool value = sorting_network_applies<RandomIt, Compare>::value &&
+                              std::is_same<typename std::iterator_traits<RandomIt>::value_type, int32_t>::value;
+};
+
+#ifdef ALGS_HAVE_SORTING_NETWORKS
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+
+// Lanes of register r that keep the minimum of their pair at step (k, j) of the bitonic sort. Key i = 4r + lane
+// is paired with key i ^ j, the pair is sorted ascending if i & k is 0 and the lower key keeps the minimum.
+inline __m128i sse41_min_lanes(int r, int j, int k) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i index = _mm_add_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(4 * r));
+    __m128i lower = _mm_cmpeq_epi32(_mm_and_si128(index, _mm_set1_epi32(j)), zero);
+    __m128i ascending = _mm_cmpeq_epi32(_mm_and_si128(index, _mm_set1_epi32(k)), zero);
+    return _mm_cmpeq_epi32(lower, ascending);
+}
+
+// Lanes swapped with their partner at distance j inside the register, j < 4.
+inline __m128i sse41_lane_partners(__m128i v, int j) {
+    if (j == 2) return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+template <int N>
+void sse41_bitonic_sort(int32_t* keys) {
+    const int R = N / 4;
+    __m128i v[R], next[R];
+#pragma GCC unroll 8
+    for (int r = 0; r < R; r++) v[r] = _mm_load_si128((const __m128i*) (keys + 4 * r));
+
+#pragma GCC unroll 8
+    for (int k = 2; k <= N; k *= 2) {
+#pragma GCC unroll 8
+        for (int j = k / 2; j > 0; j /= 2) {
+#pragma GCC unroll 8
+            for (int r = 0; r < R; r++) {
+                __m128i partner = j >= 4 ? v[r ^ (j / 4)] : sse41_lane_partners(v[r], j);
+                __m128i lo = _mm_min_epi32(v[r], partner), hi = _mm_max_epi32(v[r], partner);
+                next[r] = _mm_blendv_epi8(hi, lo, sse41_min_lanes(r, j, k));
+            }
+#pragma GCC unroll 8
+            for (int r = 0; r < R; r++) v[r] = next[r];
+        }
+    }
+
+#pragma GCC unroll 8
+    for (int r = 0; r < R; r++) _mm_store_si128((__m128i*) (keys + 4 * r), v[r]);
+}
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+// Same as sse41_min_lanes for 8 lanes, key i = 8r + lane.
+inline __m256i avx2_min_lanes(int r, int j, int k) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i index = _mm256_add_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(8 * r));
+    __m256i lower = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(j)), zero);
+    __m256i ascending = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(k)), zero);
+    return _mm256_cmpeq_epi32(lower, ascending);
+}
+
+// Lanes swapped with their partner at distance j inside the register, j < 8.
+inline __m256i avx2_lane_partners(__m256i v, int j) {
+    if (j == 4) return _mm256_permute2x128_si256(v, v, 1);
+    if (j == 2) return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+template <int N>
+void avx2_bitonic_sort(int32_t* keys) {
+    const int R = N / 8;
+    __m256i v[R], next[R];
+#pragma GCC unroll 4
+    for (int r = 0; r < R; r++) v[r] = _mm256_load_si256((const __m256i*) (keys + 8 * r));
+
+#pragma GCC unroll 8
+    for (int k = 2; k <= N; k *= 2) {
+#pragma GCC unroll 8
+        for (int j = k / 2; j > 0; j /= 2) {
+#pragma GCC unroll 4
+            for (int r = 0; r < R; r++) {
+                __m256i partner = j >= 8 ? v[r ^ (j / 8)] : avx2_lane_partners(v[r], j);
+                __m256i lo = _mm256_min_epi32(v[r], partner), hi = _mm256_max_epi32(v[r], partner);
+                next[r] = _mm256_blendv_epi8(hi, lo, avx2_min_lanes(r, j, k));
+            }
+#pragma GCC unroll 4
+            for (int r = 0; r < R; r++) v[r] = next[r];
+        }
+    }
+
+#pragma GCC unroll 4
+    for (int r = 0; r < R; r++) _mm256_store_si256((__m256i*) (keys + 8 * r), v[r]);
+}
+
+// Sorts a bitonic register ascending.
+inline __m256i avx2_bitonic_merge_register(__m256i v) {
+    for (int j = 4; j > 0; j /= 2) {
+        __m256i partner = avx2_lane_partners(v, j);
+        v = _mm256_blendv_epi8(_mm256_max_epi32(v, partner), _mm256_min_epi32(v, partner), avx2_min_lanes(0, j, 8));
+    }
+    return v;
+}
+
+// Merges two ascending registers, a receives the 8 smallest keys and b the 8 largest, both ascending.
+inline void avx2_merge_registers(__m256i& a, __m256i& b) {
+    // a followed by b reversed is bitonic, one min and max splits it into two bitonic halves.
+    b = _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    __m256i lo = _mm256_min_epi32(a, b), hi = _mm256_max_epi32(a, b);
+    a = avx2_bitonic_merge_register(lo);
+    b = avx2_bitonic_merge_register(hi);
+}
+
+template <bool FlipNegatives>
+inline __m256i avx2_flip_negatives(__m256i v) {
+    if (!FlipNegatives) return v;
+    __m256i sign = _mm256_srai_epi32(v, 31);
+    return _mm256_xor_si256(v, _mm256_and_si256(sign, _mm256_set1_epi32(0x7fffffff)));
+}
+
+template <typename T>
+inline __m256i avx2_load_keys(const T* p) {
+    return avx2_flip_negatives<NetworkKeys<T>::flips_negatives>(_mm256_loadu_si256((const __m256i*) p));
+}
+
+template <typename T>
+inline void avx2_store_keys(T* p, __m256i keys) {
+    _mm256_storeu_si256((__m256i*) p, avx2_flip_negatives<NetworkKeys<T>::flips_negatives>(keys));
+}
+
+/**
+ * Merge of two ascending runs of at least 8 elements each. Blocks of 8 are taken from the run whose next element
+ * is the smallest and merged in registers with the 8 largest keys of the previous step, the 8 smallest are
+ * written out. Every key held in registers precedes the next element of both runs, so the written keys precede
+ * everything that is left. Once a run has less than a block left, the rest is merged one element at a time.
+ */
+template <typename T>
+T* avx2_merge(const T* a, const T* a_last, const T* b, const T* b_last, T* out) {
+    __m256i low = avx2_load_keys(a), high = avx2_load_keys(b);
+    a += 8;
+    b += 8;
+    bool a_is_short;
+    while (true) {
+        avx2_merge_registers(low, high);
+        avx2_store_keys(out, low);
+        out += 8;
+
+        bool take_a = b == b_last || (a != a_last && !(*b < *a));
+        const T*& run = take_a ? a : b;
+        const T* run_last = take_a ? a_last : b_last;
+        if (run_last - run < 8) {
+            a_is_short = take_a;
+            break;
+        }
+        low = avx2_load_keys(run);
+        run += 8;
+    }
+
+    T carried[8];
+    avx2_store_keys(carried, high);
+    // The run that ran out is merged with the carried keys first, it has less than a block left.
+    T tail[16];
+    const T* short_first = a_is_short ? a : b;
+    const T* short_last = a_is_short ? a_last : b_last;
+    T* tail_last = std::merge(carried, carried + 8, short_first, short_last, tail);
+    if (a_is_short) return std::merge(tail, tail_last, b, b_last, out);
+    return std::merge(a, a_last, tail, tail_last, out);
+}
+
+#pragma GCC pop_options
+
+#endif
+
+// Sorts the n keys with the smallest kernel holding them, the rest of the kernel is padded with the largest key.
+inline void sorting_network_sort_keys(int32_t* keys, long n, SimdLevel level) {
+#ifdef ALGS_HAVE_SORTING_NETWORKS
+    long size = n <= 8 ? 8 : n <= 16 ? 16 : 32;
+    std::fill(keys + n, keys + size, INT32_MAX);
+    if (level == SimdLevel::AVX2) {
+        if (size == 8) avx2_bitonic_sort<8>(keys);
+        else if (size == 16) avx2_bitonic_sort<16>(keys);
+        else avx2_bitonic_sort<32>(keys);
+    }
+    else {
+        if (size == 8) sse41_bitonic_sort<8>(keys);
+        else if (size == 16) sse41_bitonic_sort<16>(keys);
+        else sse41_bitonic_sort<32>(keys);
+    }
+#endif
+}
+
+/**
+ * Sorts a range of at most sorting_network_max_size elements with a sorting network and returns true, or returns
+ * false without touching the range if the elements, the comparator or the CPU are not supported.
+ */
+template <typename RandomIt, typename Compare>
+typename std::enable_if<sorting_network_applies<RandomIt, Compare>::value, bool>::type
+sorting_network_sort(RandomIt first, RandomIt last, Compare) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef NetworkKeys<T> Keys;
+    auto level = sortingNetworkLevel();
+    long n = std::distance(first, last);
+    if (level == SimdLevel::None || n > sorting_network_max_size) return false;
+    if (n < 2) return true;
+
+    alignas(32) int32_t keys[sorting_network_max_size];
+    for (long i = 0; i < n; i++) keys[i] = Keys::encode(first[i]);
+    sorting_network_sort_keys(keys, n, level);
+    for (long i = 0; i < n; i++) first[i] = Keys::decode(keys[i]);
+    return true;
+}
+
+template <typename RandomIt, typename Compare>
+typename std::enable_if<!sorting_network_applies<RandomIt, Compare>::value, bool>::type
+sorting_network_sort(RandomIt, RandomIt, Compare) {
+    return false;
+}
+
+/**
+ * Merges two sorted ranges into out with vector registers and returns true, or returns false without writing
+ * anything if the elements, the comparator or the CPU are not supported, or if a run is shorter than a
+ * register. Needs AVX2.
+ */
+template <typename It1, typename It2, typename OutIt, typename Compare>
+typename std::enable_if<sorting_network_applies<It1, Compare>::value && sorting_network_applies<It2, Compare>::value &&
+                        sorting_network_applies<OutIt, Compare>::value, bool>::type
+sorting_network_merge(It1 a_first, It1 a_last, It2 b_first, It2 b_last, OutIt out, Compare) {
+#ifdef ALGS_HAVE_SORTING_NETWORKS
+    if (sortingNetworkLevel() != SimdLevel::AVX2 || a_last - a_first < 8 || b_last - b_first < 8) return false;
+    avx2_merge(&*a_first, &*a_first + (a_last - a_first), &*b_first, &*b_first + (b_last - b_first), &*out);
+    return true;
+#else
+    return false;
+#endif
+}
+
+template <typename It1, typename It2, typename OutIt, typename Compare>
+typename std::enable_if<!(sorting_network_applies<It1, Compare>::value && sorting_network_applies<It2, Compare>::value &&
+                          sorting_network_applies<OutIt, Compare>::value), bool>::type
+sorting_network_merge(It1, It1, It2, It2, OutIt, Compare) {
+    return false;
+}
+
+// Same as sorting_network_sort, but returns false for elements whose order a stable sort has to keep.
+template <typename RandomIt, typename Compare>
+bool stable_sorting_network_sort(RandomIt first, RandomIt last, Compare comp) {
+    return stable_sorting_network_applies<RandomIt, Compare>::value && sorting_network_sort(first, last, comp);
+}
+
+// Same as sorting_network_merge, but returns false for elements whose order a stable merge has to keep.
+template <typename It1, typename It2, typename OutIt, typename Compare>
+bool stable_sorting_network_merge(It1 a_first, It1 a_last, It2 b_first, It2 b_last, OutIt out, Compare comp) {
+    return stable_sorting_network_applies<It1, Compare>::value &&
+           sorting_network_merge(a_first, a_last, b_first, b_last, out, comp);
+}
+
+template <typename T>
+bool testSortingNetworksOf(SimdLevel level) {
+    auto saved = sortingNetworkLevel();
+    sortingNetworkLevel() = level;
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> dist(-50, 50);
+    bool ok = true;
+    for (long n = 0; n <= sorting_network_max_size; n++) {
+        std::vector<T> elements(n);
+        for (auto& e : elements) e = (T) dist(gen);
+        auto expected = elements;
+        std::sort(expected.begin(), expected.end());
+        ok = ok && sorting_network_sort(elements.begin(), elements.end(), std::less<T>()) && elements == expected;
+    }
+    for (long na = 8; na < 60; na += 7) {
+        for (long nb = 8; nb < 60; nb += 11) {
+            std::vector<T> a(na), b(nb), merged(na + nb), expected(na + nb);
+            for (auto& e : a) e = (T) dist(gen);
+            for (auto& e : b) e = (T) dist(gen);
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+            bool merged_by_network = sorting_network_merge(a.begin(), a.end(), b.begin(), b.end(), merged.begin(),
+                                                           std::less<T>());
+            ok = ok && (merged_by_network ? merged == expected : level != SimdLevel::AVX2);
+        }
+    }
+    sortingNetworkLevel() = saved;
+    return ok;
+}
+
+void testSortingNetworks() {
+    std::cout << "Test sorting networks.\n";
+    std::vector<int> elements = {4, -2, 9, 6, 7, 3, 8, 1, 5, 0, -7};
+    bool used = sorting_network_sort(elements.begin(), elements.end(), std::less<int>());
+    std::cout << "Sorted by a network: " << used << ", ";
+    print_range(elements.begin(), elements.end());
+
+    std::vector<float> floats = {0.5f, -0.0f, -3.25f, 0.0f, 1e30f, -1e30f, 2.0f};
+    sorting_network_sort(floats.begin(), floats.end(), std::less<float>());
+    print_range(floats.begin(), floats.end());
+    std::cout << "Stable sorts use the networks for ints: "
+              << stable_sorting_network_sort(elements.begin(), elements.end(), std::less<int>())
+              << ", for floats: " << stable_sorting_network_sort(floats.begin(), floats.end(), std::less<float>())
+              << "\n";
+
+    for (auto level : {SimdLevel::SSE41, SimdLevel::AVX2}) {
+        if (detectSimdLevel() < level) continue;
+        std::cout << (level == SimdLevel::AVX2 ? "AVX2" : "SSE4.1") << " kernels sort and merge ints and floats: "
+                  << (testSortingNetworksOf<int>(level) && testSortingNetworksOf<float>(level)) << "\n";
+    }
+}
+
+#endif //ALGS_SORTING_NETWORKS_H
@@ -11,19 +11,26 @@
 #include <random>
 #include <stack>
 #include <fstream>
+#include <cmath>
+#include <functional>
 #include "utils.h"
+#include "priority_queue.h"
+#include "sorting_networks.h"
+#include "fast_random.h"
+
+// Fisher-Yates shuffle, element i is swapped with a uniformly chosen element of the first i + 1.
+template <typename RandomIt, typename Engine>
+void knuth_shuffle(RandomIt first, RandomIt last, Engine& gen) {
+    auto n = std::distance(first, last);
+    for (decltype(n) i = 1; i < n; ++i) {
+        auto r = bounded_random(gen, (uint64_t) i + 1);
+        std::swap(*(first + i), *(first + r));
+    }
+}
 
 template <typename RandomIt>
 void knuth_shuffle(RandomIt first, RandomIt last) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    RandomIt i;
-    int index = 0, r = 0;
-    for (i = first; i != last; ++i, ++index) {
-        r = std::uniform_int_distribution<>{0, index}(gen);
-        std::swap(*i, *(first + r));
-    };
+    knuth_shuffle(first, last, defaultRandomEngine());
 }
 
 
@@ -72,6 +79,21 @@ void insertion_sort(RandomIt first, RandomIt last) {
     assert(std::is_sorted(first, last));
 }
 
+template <typename RandomIt, typename Compare>
+void insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+    RandomIt i, j;
+    for (i = first; i != last; i++) {
+        for (j = i; j != first; j--) {
+            // Strict comparison keeps equal elements in their original order.
+            if (comp(*j, *(j-1))) {
+                std::swap(*(j-1), *j);
+            }
+            else break;
+        }
+    }
+    assert(std::is_sorted(first, last, comp));
+}
+
 template <typename RandomIt>
 void shell_sort(RandomIt first, RandomIt last) {
     long n = std::distance(first, last);
@@ -160,7 +182,7 @@ std::stack<Point2D> grahamScanSTL(std::vector<Point2D> points) {
         Point2D top = hull.top();
         hull.pop();
 
-        while (Point2D::ccw(hull.top(), top, points[i]) <= 0) {
+        while (!hull.empty() && Point2D::ccw(hull.top(), top, points[i]) <= 0) {
             top = hull.top();
             hull.pop();
         }
@@ -226,7 +248,7 @@ void testGrahamScan() {
 }
 
 template <typename RandomIt, typename Container>
-void merge_sort_merge(Container aux, RandomIt lo, RandomIt mid, RandomIt hi) {
+void merge_sort_merge(Container& aux, RandomIt lo, RandomIt mid, RandomIt hi) {
     auto i = lo, j = mid;
     auto aux_lo = aux.begin(), aux_hi = aux.end();
 
@@ -248,13 +270,14 @@ void merge_sort_merge(Container aux, RandomIt lo, RandomIt mid, RandomIt hi) {
         // No more elements in right sub-range copy left elements.
         else if (j_hi_dist == 0)  { *k = getAuxElement(i); i++; }
         // Compare two elements from the auxiliary array, using index computed from original iterator.
-        else if (getAuxElement(i) < getAuxElement(j)) { *k = getAuxElement(i); i++; }
-        else                      { *k = getAuxElement(j); j++; }
+        // Equal elements are taken from the left sub-range first, which keeps the sort stable.
+        else if (getAuxElement(j) < getAuxElement(i)) { *k = getAuxElement(j); j++; }
+        else                      { *k = getAuxElement(i); i++; }
     }
 }
 
 template <typename RandomIt, typename Container>
-void merge_sort_merge_smarter(Container aux, RandomIt lo, RandomIt mid, RandomIt hi) {
+void merge_sort_merge_smarter(Container& aux, RandomIt lo, RandomIt mid, RandomIt hi) {
     auto i = lo, j = mid;
     auto aux_lo = aux.begin();
     auto aux_it = aux_lo;
@@ -266,9 +289,9 @@ void merge_sort_merge_smarter(Container aux, RandomIt lo, RandomIt mid, RandomIt
         if      (i_mid_dist == 0) { *aux_it = *j; j++; }
         // No more elements in right sub-range copy left elements.
         else if (j_hi_dist == 0)  { *aux_it = *i; i++; }
-        // Compare two elements from the auxiliary array, using index computed from original iterator.
-        else if (*i < *j)         { *aux_it = *i; i++; }
-        else                      { *aux_it = *j; j++; }
+        // Equal elements are taken from the left sub-range first, which keeps the sort stable.
+        else if (*j < *i)         { *aux_it = *j; j++; }
+        else                      { *aux_it = *i; i++; }
     }
 
     // Copy sorted elements from auxiliary array back to original range.
@@ -276,7 +299,7 @@ void merge_sort_merge_smarter(Container aux, RandomIt lo, RandomIt mid, RandomIt
 }
 
 template <typename RandomIt, typename Container>
-void merge_sort_recursive(Container aux, RandomIt lo, RandomIt hi) {
+void merge_sort_recursive(Container& aux, RandomIt lo, RandomIt hi) {
     long n = std::distance(lo, hi);
     if (n < 2) return;
     auto mid = lo + (n / 2);
@@ -285,13 +308,106 @@ void merge_sort_recursive(Container aux, RandomIt lo, RandomIt hi) {
     merge_sort_merge_smarter(aux, lo, mid, hi);
 }
 
+// Stable merge of [a_first, a_last) and [b_first, b_last) moved into out.
+template <typename It1, typename It2, typename OutIt, typename Compare>
+OutIt merge_move(It1 a_first, It1 a_last, It2 b_first, It2 b_last, OutIt out, Compare comp) {
+    while (a_first != a_last && b_first != b_last) {
+        if (comp(*b_first, *a_first)) { *out = std::move(*b_first); ++b_first; }
+        else                          { *out = std::move(*a_first); ++a_first; }
+        ++out;
+    }
+    out = std::move(a_first, a_last, out);
+    return std::move(b_first, b_last, out);
+}
+
+// Runs up to this size are sorted with a sorting network or insertion sort, which beat merging on small inputs.
+const long merge_sort_insertion_cutoff = 32;
+
+template <typename RandomIt, typename ScratchIt, typename Compare>
+void merge_sort_into(RandomIt first, RandomIt last, ScratchIt out, Compare comp);
+
+// Sorts [first, last) in place, using the n elements starting at scratch as auxiliary storage.
+template <typename RandomIt, typename ScratchIt, typename Compare>
+void merge_sort_in_place(RandomIt first, RandomIt last, ScratchIt scratch, Compare comp) {
+    auto n = std::distance(first, last);
+    if (n <= merge_sort_insertion_cutoff) {
+        if (!stable_sorting_network_sort(first, last, comp)) insertion_sort(first, last, comp);
+        return;
+    }
+    auto half = n / 2;
+    auto mid = first + half;
+    // Sort the halves into the scratch buffer and merge them back. Source and destination swap roles on every
+    // level, so there is no copy back step.
+    merge_sort_into(first, mid, scratch, comp);
+    merge_sort_into(mid, last, scratch + half, comp);
+    if (!stable_sorting_network_merge(scratch, scratch + half, scratch + half, scratch + n, first, comp)) {
+        merge_move(scratch, scratch + half, scratch + half, scratch + n, first, comp);
+    }
+}
+
+// Sorts [first, last) into the n elements starting at out, using the input range as auxiliary storage.
+template <typename RandomIt, typename ScratchIt, typename Compare>
+void merge_sort_into(RandomIt first, RandomIt last, ScratchIt out, Compare comp) {
+    auto n = std::distance(first, last);
+    if (n <= merge_sort_insertion_cutoff) {
+        std::move(first, last, out);
+        if (!stable_sorting_network_sort(out, out + n, comp)) insertion_sort(out, out + n, comp);
+        return;
+    }
+    auto half = n / 2;
+    auto mid = first + half;
+    merge_sort_in_place(first, mid, out, comp);
+    merge_sort_in_place(mid, last, out + half, comp);
+    if (!stable_sorting_network_merge(first, mid, mid, last, out, comp)) {
+        merge_move(first, mid, mid, last, out, comp);
+    }
+}
+
+/**
+ * Stable merge sort that does not allocate. The caller supplies a scratch range of at least
+ * std::distance(first, last) elements, whose contents are overwritten.
+ */
+template <typename RandomIt, typename ScratchIt, typename Compare>
+void merge_sort_with_scratch(RandomIt first, RandomIt last, ScratchIt scratch, Compare comp) {
+    merge_sort_in_place(first, last, scratch, comp);
+    assert(std::is_sorted(first, last, comp));
+}
+
+template <typename RandomIt, typename ScratchIt>
+void merge_sort_with_scratch(RandomIt first, RandomIt last, ScratchIt scratch) {
+    merge_sort_with_scratch(first, last, scratch, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
 template <typename RandomIt>
 void merge_sort(RandomIt first, RandomIt last) {
-    std::vector<typename RandomIt::value_type> aux(first, last);
-    merge_sort_recursive(aux, first, last);
-    assert(std::is_sorted(first, last));
+    // The single allocation of the whole sort.
+    std::vector<typename RandomIt::value_type> scratch(first, last);
+    merge_sort_with_scratch(first, last, scratch.begin());
 }
 
+/**
+ * Merge sort that keeps its scratch buffer between calls, so that sorting many ranges only allocates when a
+ * range is larger than every previous one.
+ */
+template <typename T, typename Compare = std::less<T> >
+class MergeSorter {
+public:
+    MergeSorter(Compare _comp = Compare()) : comp(_comp) {}
+
+    template <typename RandomIt>
+    void sort(RandomIt first, RandomIt last) {
+        auto n = (size_t) std::distance(first, last);
+        if (scratch.size() < n) scratch.resize(n);
+        merge_sort_with_scratch(first, last, scratch.begin(), comp);
+    }
+
+    size_t capacity() const { return scratch.size(); }
+
+private:
+    std::vector<T> scratch;
+    Compare comp;
+};
+
 template <typename RandomIt>
 void bottom_up_merge_sort(RandomIt first, RandomIt last) {
     std::vector<typename RandomIt::value_type> aux(first, last);
@@ -365,6 +481,9 @@ RandomIt medianOf3(RandomIt first, RandomIt last_inclusive) {
 template <typename RandomIt>
 void quick_sort_recursive(RandomIt first, RandomIt last) {
     long n = std::distance(first, last);
+    if (n <= sorting_network_max_size && sorting_network_sort(first, last, std::less<typename RandomIt::value_type>())) {
+        return;
+    }
     if (n < 5) {
         insertion_sort(first, last);
         return;
@@ -385,6 +504,105 @@ void quick_sort(RandomIt first, RandomIt last) {
     assert(std::is_sorted(first, last));
 }
 
+// Same as partition, ordering elements with comp. The range must have at least two elements. Not overloading
+// partition, since argument dependent lookup would make calls ambiguous with std::partition.
+template <typename RandomIt, typename Compare>
+RandomIt hoare_partition(RandomIt first, RandomIt last, Compare comp) {
+    auto p = first, i = first, j = last;
+
+    while (true) {
+        while(comp(*(++i), *p)) {
+            if (i == last - 1) break;
+        }
+        while(comp(*p, *(--j))) {
+            if (j == first) break;
+        }
+        if (i >= j) break;
+        std::swap(*i, *j);
+    }
+    std::swap(*p, *j);
+    return j;
+}
+
+template <typename RandomIt, typename Compare>
+RandomIt medianOf3(RandomIt a, RandomIt b, RandomIt c, Compare comp) {
+    if (comp(*a, *b)) {
+        if (comp(*b, *c)) return b;
+        return comp(*a, *c) ? c : a;
+    }
+    if (comp(*c, *b)) return b;
+    return comp(*c, *a) ? c : a;
+}
+
+// Tukey's ninther, the median of the medians of three evenly spaced triples. A better pivot estimate than
+// medianOf3 on large ranges, and one that is much harder to fool with crafted inputs.
+template <typename RandomIt, typename Compare>
+RandomIt ninther(RandomIt first, RandomIt last_inclusive, Compare comp) {
+    auto step = std::distance(first, last_inclusive) / 8;
+    auto mid = std::next(first, std::distance(first, last_inclusive) / 2);
+    return medianOf3(medianOf3(first, first + step, first + 2 * step, comp),
+                     medianOf3(mid - step, mid, mid + step, comp),
+                     medianOf3(last_inclusive - 2 * step, last_inclusive - step, last_inclusive, comp), comp);
+}
+
+const long intro_sort_insertion_cutoff = 16;
+const long intro_sort_ninther_threshold = 128;
+
+template <typename RandomIt, typename Compare>
+void intro_sort_recursive(RandomIt first, RandomIt last, long depth_limit, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    while (true) {
+        long n = std::distance(first, last);
+        if (n <= sorting_network_max_size && sorting_network_sort(first, last, comp)) return;
+        if (n <= intro_sort_insertion_cutoff) {
+            insertion_sort(first, last, comp);
+            return;
+        }
+        if (depth_limit == 0) {
+            // Too many bad pivots, switch to the O(n log n) worst case of heap sort. heap_sort leaves the
+            // elements in reverse comp order, hence the flipped comparator.
+            heap_sort(first, last, [&comp](const T& a, const T& b) { return comp(b, a); });
+            return;
+        }
+        --depth_limit;
+
+        auto pivot = n >= intro_sort_ninther_threshold ? ninther(first, last - 1, comp)
+                                                        : medianOf3(first, first + n / 2, last - 1, comp);
+        std::swap(*first, *pivot);
+        auto p = hoare_partition(first, last, comp);
+
+        // Recurse into the smaller side and loop on the larger one, which bounds the stack depth to O(log n).
+        if (std::distance(first, p) < std::distance(p + 1, last)) {
+            intro_sort_recursive(first, p, depth_limit, comp);
+            first = p + 1;
+        }
+        else {
+            intro_sort_recursive(p + 1, last, depth_limit, comp);
+            last = p;
+        }
+    }
+}
+
+/**
+ * Introsort, quick sort with a guaranteed O(n log n) worst case and no shuffle.
+ *
+ * Pivots are chosen with medianOf3 or ninther, partitions of up to 16 elements are finished with insertion sort,
+ * and once the recursion gets deeper than 2 * log2(n) the current partition is sorted with heap sort.
+ */
+template <typename RandomIt, typename Compare>
+void intro_sort(RandomIt first, RandomIt last, Compare comp) {
+    long n = std::distance(first, last);
+    if (n < 2) return;
+    long depth_limit = 2 * (long) std::log2((double) n);
+    intro_sort_recursive(first, last, depth_limit, comp);
+    assert(std::is_sorted(first, last, comp));
+}
+
+template <typename RandomIt>
+void intro_sort(RandomIt first, RandomIt last) {
+    intro_sort(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
 template <typename RandomIt>
 RandomIt quick_select(RandomIt first, RandomIt last, long n) {
     long dist = std::distance(first, last);
@@ -420,13 +638,17 @@ RandomIt quick_select(RandomIt first, RandomIt last, long n) {
 
 template <typename RandomIt, typename Comparator>
 void quick_sort_3_way_recursive(RandomIt first, RandomIt last, Comparator comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
     long n = std::distance(first, last);
+    if (n <= sorting_network_max_size && sorting_network_sort(first, last, comp)) return;
     if (n < 3) {
-        insertion_sort(first, last);
+        insertion_sort(first, last, [&comp](const T& a, const T& b) { return comp(a, b) < 0; });
         return;
     }
 
-    auto median = medianOf3(first, last - 1);
+    auto median = medianOf3(first, first + (n - 1) / 2, last - 1, [&comp](const T& a, const T& b) {
+        return comp(a, b) < 0;
+    });
     std::swap(*first, *median);
 
     auto lt = first, gt = last - 1, i = first + 1;
@@ -446,14 +668,23 @@ void quick_sort_3_way(RandomIt first, RandomIt last, Comparator comp) {
     quick_sort_3_way_recursive(first, last, comp);
 }
 
-template <typename RandomIt>
-void quick_sort_3_way(RandomIt first, RandomIt last) {
-    knuth_shuffle(first, last);
-    quick_sort_3_way_recursive(first, last, [](const typename RandomIt::value_type& a, const typename RandomIt::value_type& b) {
+// Three way comparison by the natural < and >, the default of quick_sort_3_way.
+template <typename T>
+struct ThreeWayCompare {
+    int operator()(const T& a, const T& b) const {
         if (a < b) return -1;
         if (a > b) return 1;
         return 0;
-    });
+    }
+};
+
+template <typename T>
+struct is_natural_order<ThreeWayCompare<T>, T> : std::true_type {};
+
+template <typename RandomIt>
+void quick_sort_3_way(RandomIt first, RandomIt last) {
+    knuth_shuffle(first, last);
+    quick_sort_3_way_recursive(first, last, ThreeWayCompare<typename RandomIt::value_type>());
 }
 
 template <typename RandomIt>
@@ -534,6 +765,25 @@ void testSorts() {
     merge_sort(elements5.begin(), elements5.end());
     print_range(elements5.begin(), elements5.end());
 
+    // -0.0 and 0.0 compare equal, a stable sort keeps them in input order.
+    std::vector<float> zeros(1000);
+    std::mt19937 zeros_gen(11);
+    for (auto& z : zeros) z = zeros_gen() % 2 ? 0.0f : -0.0f;
+    auto stable_zeros = zeros;
+    std::stable_sort(stable_zeros.begin(), stable_zeros.end());
+    merge_sort(zeros.begin(), zeros.end());
+    bool same_signs = true;
+    for (size_t i = 0; i < zeros.size(); i++) same_signs &= std::signbit(zeros[i]) == std::signbit(stable_zeros[i]);
+    std::cout << "Merge sort keeps equal floats in order: " << same_signs << "\n";
+
+    std::cout << "Test merge sort with reused scratch buffer.\n";
+    MergeSorter<int, std::greater<int> > merge_sorter;
+    auto elements5_copy = elements5;
+    merge_sorter.sort(elements5_copy.begin(), elements5_copy.end());
+    print_range(elements5_copy.begin(), elements5_copy.end());
+    merge_sorter.sort(elements5_copy.begin(), elements5_copy.begin() + 4);
+    print_range(elements5_copy.begin(), elements5_copy.end());
+
     std::cout << "Test bottom up merge sort.\n";
     bottom_up_merge_sort(elements6.begin(), elements6.end());
     print_range(elements6.begin(), elements6.end());
@@ -542,6 +792,35 @@ void testSorts() {
     quick_sort(elements7.begin(), elements7.end());
     print_range(elements7.begin(), elements7.end());
 
+    std::cout << "Test intro sort.\n";
+    auto elements7_intro = elements7;
+    knuth_shuffle(elements7_intro.begin(), elements7_intro.end());
+    intro_sort(elements7_intro.begin(), elements7_intro.end());
+    print_range(elements7_intro.begin(), elements7_intro.end());
+    intro_sort(elements7_intro.begin(), elements7_intro.end(), std::greater<int>());
+    print_range(elements7_intro.begin(), elements7_intro.end());
+    // Organ pipe input, 0 1 2 ... n/2 ... 2 1 0, degrades naive median of 3 pivots.
+    std::vector<int> organ_pipe;
+    for (int i = 0; i < 50000; i++) organ_pipe.push_back(std::min(i, 50000 - i));
+    intro_sort(organ_pipe.begin(), organ_pipe.end());
+    std::cout << "Organ pipe input sorted: " << std::is_sorted(organ_pipe.begin(), organ_pipe.end()) << "\n";
+    // Depth limits of 0 and 1 go to the heap sort fallback right away and after one partition, with both
+    // comparators, as heap sort runs with the flipped one.
+    std::vector<int> fallback_input(1000);
+    std::mt19937 fallback_gen(7);
+    for (auto& v : fallback_input) v = (int) (fallback_gen() % 200);
+    bool fallback_sorted = true;
+    for (long depth_limit : {0, 1}) {
+        auto ascending = fallback_input, expected_ascending = fallback_input;
+        intro_sort_recursive(ascending.begin(), ascending.end(), depth_limit, std::less<int>());
+        std::sort(expected_ascending.begin(), expected_ascending.end());
+        auto descending = fallback_input, expected_descending = fallback_input;
+        intro_sort_recursive(descending.begin(), descending.end(), depth_limit, std::greater<int>());
+        std::sort(expected_descending.begin(), expected_descending.end(), std::greater<int>());
+        fallback_sorted &= ascending == expected_ascending && descending == expected_descending;
+    }
+    std::cout << "Heap sort fallback matches std::sort: " << fallback_sorted << "\n";
+
     std::cout << "Test quick select.\n";
     auto quick_select_it = quick_select(elements8.begin(), elements8.end(), 8);
     if (quick_select_it != elements8.end()) {
@@ -0,0 +1,175 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_SUCCESSOR_SET_H
+#define ALGS_SUCCESSOR_SET_H
+
+#include <assert.h>
+#include <cstdint>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <iostream>
+
+/**
+ * Set of integers in [0, universe) with successor and predecessor queries, as a 64-ary tree of bitsets.
+ *
+ * The bottom level holds one bit per integer. Every level above holds one bit per word of the level below,
+ * set if that word is not empty, up to a level of a single word. An update touches one word per level, and a
+ * query scans at most one word per level up and one per level down with count trailing or leading zeros, so
+ * every operation is O(log_64 universe), 4 levels for 2^24 integers. The bits take universe / 8 bytes, about
+ * 1/63 more for the upper levels.
+ *
+ * Queries return universe() when there is no answer.
+ */
+class SuccessorSet {
+public:
+    // full puts every integer of the universe in the set.
+    explicit SuccessorSet(size_t universe, bool full = false) : universe_size(universe) {
+        size_t bits = universe;
+        do {
+            levels.push_back(std::vector<uint64_t>((bits + 63) / 64));
+            bits = levels.back().size();
+        } while (bits > 1);
+        if (full) fill();
+    }
+
+    size_t universe() const { return universe_size; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    bool contains(size_t x) const {
+        assert(x < universe_size);
+        return (levels[0][x / 64] >> (x % 64)) & 1;
+    }
+
+    // Returns false if x was already in the set.
+    bool insert(size_t x) {
+        assert(x < universe_size);
+        if (contains(x)) return false;
+        count++;
+        for (auto& level : levels) {
+            auto& word = level[x / 64];
+            bool was_empty = word == 0;
+            word |= 1ULL << (x % 64);
+            if (!was_empty) break;
+            x /= 64;
+        }
+        return true;
+    }
+
+    // Returns false if x was not in the set.
+    bool remove(size_t x) {
+        assert(x < universe_size);
+        if (!contains(x)) return false;
+        count--;
+        for (auto& level : levels) {
+            auto& word = level[x / 64];
+            word &= ~(1ULL << (x % 64));
+            if (word != 0) break;
+            x /= 64;
+        }
+        return true;
+    }
+
+    // Smallest element >= x.
+    size_t successor(size_t x) const {
+        if (x >= universe_size) return universe_size;
+        size_t level = 0;
+        while (true) {
+            auto& words = levels[level];
+            if (x / 64 >= words.size()) return universe_size;
+            uint64_t word = words[x / 64] & (~0ULL << (x % 64));
+            if (word) {
+                x = x / 64 * 64 + __builtin_ctzll(word);
+                break;
+            }
+            if (++level == levels.size()) return universe_size;
+            x = x / 64 + 1;
+        }
+        while (level > 0) {
+            level--;
+            x = x * 64 + __builtin_ctzll(levels[level][x]);
+        }
+        return x;
+    }
+
+    // Largest element <= x.
+    size_t predecessor(size_t x) const {
+        if (count == 0) return universe_size;
+        if (x >= universe_size) x = universe_size - 1;
+        size_t level = 0;
+        while (true) {
+            uint64_t word = levels[level][x / 64] & (~0ULL >> (63 - x % 64));
+            if (word) {
+                x = x / 64 * 64 + 63 - __builtin_clzll(word);
+                break;
+            }
+            if (x < 64 || ++level == levels.size()) return universe_size;
+            x = x / 64 - 1;
+        }
+        while (level > 0) {
+            level--;
+            x = x * 64 + 63 - __builtin_clzll(levels[level][x]);
+        }
+        return x;
+    }
+
+    size_t min() const { return successor(0); }
+    size_t max() const { return predecessor(universe_size); }
+
+    void clear() {
+        for (auto& level : levels) std::fill(level.begin(), level.end(), 0);
+        count = 0;
+    }
+
+    // Puts every integer of the universe in the set.
+    void fill() {
+        size_t bits = universe_size;
+        for (auto& level : levels) {
+            std::fill(level.begin(), level.end(), ~0ULL);
+            if (bits % 64) level.back() = (1ULL << (bits % 64)) - 1;
+            bits = level.size();
+        }
+        count = universe_size;
+    }
+
+private:
+    size_t universe_size;
+    size_t count = 0;
+    // levels[0] holds the elements, levels.back() is a single word.
+    std::vector<std::vector<uint64_t> > levels;
+};
+
+void testSuccessorSet() {
+    std::cout << "Test successor set.\n";
+    SuccessorSet set(300000);
+    for (size_t x : {5, 64, 4095, 4096, 299999}) set.insert(x);
+    std::cout << "Successors: " << set.successor(0) << " " << set.successor(6) << " " << set.successor(4097)
+              << " " << set.successor(299999) << ", predecessors: " << set.predecessor(63) << " "
+              << set.predecessor(4095) << " " << set.predecessor(299998) << " " << set.predecessor(4) << "\n";
+    set.remove(4095);
+    set.remove(4096);
+    std::cout << "After removing 4095 and 4096: " << set.successor(65) << " " << set.predecessor(299998) << ", size "
+              << set.size() << "\n";
+
+    // Random updates checked against a plain bitmap.
+    const size_t universe = 100000;
+    SuccessorSet random(universe, true);
+    std::vector<bool> present(universe, true);
+    std::mt19937 gen(1);
+    bool matches = random.size() == universe && random.max() == universe - 1;
+    for (int i = 0; i < 200000; i++) {
+        size_t x = gen() % universe;
+        if (gen() % 3) random.remove(x), present[x] = false;
+        else random.insert(x), present[x] = true;
+        size_t q = gen() % universe, next = q, previous = q;
+        while (next < universe && !present[next]) next++;
+        while (previous < universe && !present[previous]) previous = previous == 0 ? universe : previous - 1;
+        matches &= random.successor(q) == next && random.predecessor(q) == previous;
+    }
+    std::cout << "Random updates match a bitmap: " << matches << "\n";
+}
+
+#endif //ALGS_SUCCESSOR_SET_H
@@ -0,0 +1,140 @@
+//
+// Created by Placinta on 10/17/26.
+//
+
+#ifndef ALGS_THREAD_POOL_H
+#define ALGS_THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <iostream>
+
+/**
+ * Fixed size pool of worker threads executing tasks in FIFO order.
+ *
+ * Tasks must not block waiting on other tasks of the same pool, otherwise all workers can end up waiting and
+ * the pool deadlocks. Fork-join algorithms should therefore submit a whole level of work from the calling thread
+ * and wait for it there.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = defaultThreadCount()) : stopping(false) {
+        if (thread_count == 0) thread_count = 1;
+        for (size_t i = 0; i < thread_count; i++) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    template <typename F>
+    std::future<typename std::result_of<F()>::type> submit(F f) {
+        typedef typename std::result_of<F()>::type R;
+        // packaged_task is move-only while std::function must be copyable, hence the shared_ptr.
+        auto task = std::make_shared<std::packaged_task<R()> >(f);
+        auto future = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push([task]() { (*task)(); });
+        }
+        condition.notify_one();
+        return future;
+    }
+
+    size_t size() const { return workers.size(); }
+
+    static size_t defaultThreadCount() {
+        auto n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+    // Process wide pool sized to the hardware, created on first use.
+    static ThreadPool& defaultPool() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+private:
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()> > tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+};
+
+// Waits for every future, rethrowing the first exception a task threw.
+template <typename T>
+void waitAll(std::vector<std::future<T> >& futures) {
+    for (auto& f : futures) {
+        f.get();
+    }
+}
+
+// Splits [0, n) into one contiguous chunk per pool thread and calls f(lo, hi) for each chunk in parallel.
+template <typename F>
+void parallelFor(ThreadPool& pool, size_t n, F f) {
+    auto chunks = std::min(pool.size(), n);
+    if (chunks <= 1) {
+        if (n > 0) f((size_t) 0, n);
+        return;
+    }
+    std::vector<std::future<void> > futures;
+    for (size_t c = 0; c < chunks; c++) {
+        size_t lo = n * c / chunks, hi = n * (c + 1) / chunks;
+        futures.push_back(pool.submit([f, lo, hi]() { f(lo, hi); }));
+    }
+    waitAll(futures);
+}
+
+void testThreadPool() {
+    std::cout << "Test thread pool.\n";
+    ThreadPool pool(4);
+    std::vector<std::future<long> > futures;
+    for (long i = 1; i <= 8; i++) {
+        futures.push_back(pool.submit([i]() { return i * i; }));
+    }
+    long sum = 0;
+    for (auto& f : futures) sum += f.get();
+    std::cout << "Sum of squares 1..8 computed on " << pool.size() << " threads: " << sum << "\n";
+
+    std::vector<int> counts(1000, 0);
+    parallelFor(pool, counts.size(), [&counts](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; i++) counts[i]++;
+    });
+    std::cout << "Parallel for touched every element once: " << (std::count(counts.begin(), counts.end(), 1) == 1000) << "\n";
+}
+
+#endif //ALGS_THREAD_POOL_H
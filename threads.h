@@ -6,6 +6,7 @@
 #define ALGS_THREADS_H
 
 #include <thread>
+#include <mutex>
 
 void testThreads() {
     std::cout << "Test mutexes.\n";
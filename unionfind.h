@@ -9,21 +9,65 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <cstdint>
+#include <numeric>
+#include <iterator>
+#include <limits>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
 #include "benchmark.h"
+#include "mapped_file.h"
+#include "successor_set.h"
+
+// How many pairs ahead of the current one joinBatch and connectedBatch prefetch the elements of. The parents of
+// the elements half as far ahead are in cache by then and get prefetched too.
+const size_t uf_prefetch_distance = 16;
+
+/**
+ * Calls visit(a, b) on every pair of [first, last) in order, while prefetching the first two hops of the root
+ * walks of the pairs ahead. Random pairs on a union-find larger than the cache miss on nearly every hop, and a
+ * walk cannot issue the load of the next hop before the previous one returned. Issuing them ahead overlaps the
+ * misses of many pairs.
+ *
+ * prefetch(x) prefetches the parent word of x, and prefetch_parent(x), called when that word is in cache,
+ * prefetches the word of the parent of x unless x is a root.
+ */
+template <typename PairIt, typename Prefetch, typename PrefetchParent, typename Visit>
+void uf_prefetched_pairs(PairIt first, PairIt last, Prefetch prefetch, PrefetchParent prefetch_parent,
+                         Visit visit) {
+    const size_t half_distance = uf_prefetch_distance / 2;
+    auto m = (size_t) std::distance(first, last);
+    for (size_t i = 0; i < m; i++) {
+        if (i + uf_prefetch_distance < m) {
+            prefetch(first[i + uf_prefetch_distance].first);
+            prefetch(first[i + uf_prefetch_distance].second);
+        }
+        if (i + half_distance < m) {
+            prefetch_parent(first[i + half_distance].first);
+            prefetch_parent(first[i + half_distance].second);
+        }
+        visit(first[i].first, first[i].second);
+    }
+}
 
 class QuickFindUF {
 public:
-    QuickFindUF (unsigned long n) : size(n) {
-        components.reserve(n);
-        for (unsigned long i = 0; i < n; i++) {
-            components[i] = i;
-        }
+    QuickFindUF (unsigned long n) : components(n), size(n) {
+        std::iota(components.begin(), components.end(), 0UL);
     }
 
     void join(unsigned long a, unsigned long b) {
         unsigned long a_component = components[a];
         unsigned long b_component = components[b];
-        for (unsigned long i = 0; i < size; i++) {
+        if (a_component == b_component) return;
+        size--;
+        for (unsigned long i = 0; i < components.size(); i++) {
             if (components[i] == a_component) {
                 components[i] = b_component;
             }
@@ -54,17 +98,16 @@ private:
 
 class QuickUnionUF {
 public:
-    QuickUnionUF (unsigned long n) : size(n) {
-        parents.reserve(n);
-        for (unsigned long i = 0; i < n; i++) {
-            parents[i] = i;
-        }
+    QuickUnionUF (unsigned long n) : parents(n), size(n) {
+        std::iota(parents.begin(), parents.end(), 0UL);
     }
 
     void join(unsigned long a, unsigned long b) {
         unsigned long a_component = root(a);
         unsigned long b_component = root(b);
+        if (a_component == b_component) return;
         parents[a_component] = b_component;
+        size--;
     }
 
     unsigned long root(unsigned long a) {
@@ -98,15 +141,17 @@ private:
 
 class WeightedQuickUnionUF {
 public:
-    WeightedQuickUnionUF (unsigned long n) : size(n) {
-        parents.reserve(n);
-        ranks.reserve(n);
-        maxes.reserve(n);
-        for (unsigned long i = 0; i < n; i++) {
-            parents[i] = i;
-            ranks[i] = 1;
-            maxes[i] = i;
-        }
+    WeightedQuickUnionUF (unsigned long n) : parents(n), ranks(n, 1), maxes(n), size(n) {
+        std::iota(parents.begin(), parents.end(), 0UL);
+        std::iota(maxes.begin(), maxes.end(), 0UL);
+    }
+
+    // Makes every element its own component again, reusing the storage.
+    void reset() {
+        std::iota(parents.begin(), parents.end(), 0UL);
+        std::fill(ranks.begin(), ranks.end(), 1UL);
+        std::iota(maxes.begin(), maxes.end(), 0UL);
+        size = parents.size();
     }
 
     void join(unsigned long a, unsigned long b) {
@@ -126,6 +171,23 @@ public:
         size--;
     }
 
+    // Joins the pairs of [first, last) in order, with the same result as calling join on each of them.
+    template <typename PairIt>
+    void joinBatch(PairIt first, PairIt last) {
+        uf_prefetched_pairs(first, last, [this](unsigned long a) { prefetch(a); },
+                            [this](unsigned long a) { prefetchParent(a); },
+                            [this](unsigned long a, unsigned long b) { join(a, b); });
+    }
+
+    // Writes connected(a, b) for every pair of [first, last) to out.
+    template <typename PairIt, typename OutputIt>
+    OutputIt connectedBatch(PairIt first, PairIt last, OutputIt out) {
+        uf_prefetched_pairs(first, last, [this](unsigned long a) { prefetch(a); },
+                            [this](unsigned long a) { prefetchParent(a); },
+                            [this, &out](unsigned long a, unsigned long b) { *out++ = connected(a, b); });
+        return out;
+    }
+
     unsigned long root(unsigned long a) {
         while (a != parents[a]) {
             parents[a] = parents[parents[a]];
@@ -151,6 +213,15 @@ public:
     }
 
 private:
+    void prefetch(unsigned long a) {
+        __builtin_prefetch(&parents[a]);
+    }
+
+    void prefetchParent(unsigned long a) {
+        unsigned long parent = parents[a];
+        if (parent != a) __builtin_prefetch(&parents[parent]);
+    }
+
     std::vector<unsigned long> parents;
     std::vector<unsigned long> ranks;
     std::vector<unsigned long> maxes;
@@ -159,15 +230,9 @@ private:
 
 class WeightedQuickUnionUFHeight {
 public:
-    WeightedQuickUnionUFHeight (unsigned long n) : size(n) {
-        parents.reserve(n);
-        heights.reserve(n);
-        maxes.reserve(n);
-        for (unsigned long i = 0; i < n; i++) {
-            parents[i] = i;
-            heights[i] = 1;
-            maxes[i] = i;
-        }
+    WeightedQuickUnionUFHeight (unsigned long n) : parents(n), heights(n, 1), maxes(n), size(n) {
+        std::iota(parents.begin(), parents.end(), 0UL);
+        std::iota(maxes.begin(), maxes.end(), 0UL);
     }
 
     void join(unsigned long a, unsigned long b) {
@@ -218,9 +283,265 @@ private:
     unsigned long size;
 };
 
+// Component maxima policies of CompactUF. Without one, findComponentMax does not compile and nothing is stored.
+template <typename Index>
+class NoComponentMax {
+public:
+    explicit NoComponentMax(Index) {}
+    void reset() {}
+    void merge(Index, Index) {}
+
+    template <typename Unused = void>
+    Index max(Index) const {
+        static_assert(!std::is_void<Unused>::value, "Use TrackComponentMax to query component maxima.");
+        return 0;
+    }
+};
+
+template <typename Index>
+class TrackComponentMax {
+public:
+    explicit TrackComponentMax(Index n) : maxes(n) {
+        reset();
+    }
+
+    void reset() {
+        std::iota(maxes.begin(), maxes.end(), (Index) 0);
+    }
+
+    // Called when the root from is linked under the root into.
+    void merge(Index into, Index from) {
+        maxes[into] = std::max(maxes[into], maxes[from]);
+    }
+
+    Index max(Index root) const {
+        return maxes[root];
+    }
+
+private:
+    std::vector<Index> maxes;
+};
+
+/**
+ * Weighted quick union with path halving in one array of Index words, 4 bytes per element for uint32_t indices
+ * against 24 for WeightedQuickUnionUF.
+ *
+ * A word with the top bit clear is the parent of its element. A word with the top bit set marks a root, and its
+ * other bits hold the size of the component, so n has to stay below 2^31 for 32 bit indices. Component maxima
+ * cost another Index per element, and are only kept with the TrackComponentMax policy.
+ */
+template <typename Index = uint32_t, template <typename> class MaxPolicy = NoComponentMax>
+class CompactUF {
+    static_assert(std::is_unsigned<Index>::value, "Indices have to be unsigned.");
+
+public:
+    // Throws std::length_error if n does not fit next to the root flag.
+    CompactUF (unsigned long n) : words(checkedSize(n), root_flag | 1), maxes((Index) n), size((Index) n) {}
+
+    // Makes every element its own component again, reusing the storage.
+    void reset() {
+        std::fill(words.begin(), words.end(), root_flag | 1);
+        maxes.reset();
+        size = (Index) words.size();
+    }
+
+    void join(Index a, Index b) {
+        Index a_component = root(a);
+        Index b_component = root(b);
+        if (a_component == b_component) return;
+        Index a_size = words[a_component] & ~root_flag;
+        Index b_size = words[b_component] & ~root_flag;
+        if (a_size > b_size) std::swap(a_component, b_component);
+        words[b_component] = root_flag | (a_size + b_size);
+        words[a_component] = b_component;
+        maxes.merge(b_component, a_component);
+        size--;
+    }
+
+    // Joins the pairs of [first, last) in order, with the same result as calling join on each of them.
+    template <typename PairIt>
+    void joinBatch(PairIt first, PairIt last) {
+        uf_prefetched_pairs(first, last, [this](Index a) { prefetch(a); }, [this](Index a) { prefetchParent(a); },
+                            [this](Index a, Index b) { join(a, b); });
+    }
+
+    // Writes connected(a, b) for every pair of [first, last) to out.
+    template <typename PairIt, typename OutputIt>
+    OutputIt connectedBatch(PairIt first, PairIt last, OutputIt out) {
+        uf_prefetched_pairs(first, last, [this](Index a) { prefetch(a); }, [this](Index a) { prefetchParent(a); },
+                            [this, &out](Index a, Index b) { *out++ = connected(a, b); });
+        return out;
+    }
+
+    Index root(Index a) {
+        while (!(words[a] & root_flag)) {
+            Index parent = words[a];
+            Index grandparent = words[parent];
+            if (grandparent & root_flag) return parent;
+            words[a] = grandparent;
+            a = grandparent;
+        }
+        return a;
+    }
+
+    bool connected(Index a, Index b) {
+        return root(a) == root(b);
+    }
+
+    Index find(Index a) {
+        return root(a);
+    }
+
+    Index findComponentMax(Index a) {
+        return maxes.max(root(a));
+    }
+
+    Index componentSize(Index a) {
+        return words[root(a)] & ~root_flag;
+    }
+
+    Index count() {
+        return size;
+    }
+
+    static const Index root_flag = (Index) 1 << (sizeof(Index) * 8 - 1);
+    static const Index max_size = root_flag - 1;
+
+private:
+    static unsigned long checkedSize(unsigned long n) {
+        if (n > (unsigned long) max_size) throw std::length_error("CompactUF: too many elements for the index type.");
+        return n;
+    }
+
+    void prefetch(Index a) {
+        __builtin_prefetch(&words[a]);
+    }
+
+    void prefetchParent(Index a) {
+        Index word = words[a];
+        if (!(word & root_flag)) __builtin_prefetch(&words[word]);
+    }
+
+    std::vector<Index> words;
+    MaxPolicy<Index> maxes;
+    Index size;
+};
+
+template <typename Index, template <typename> class MaxPolicy>
+const Index CompactUF<Index, MaxPolicy>::root_flag;
+
+template <typename Index, template <typename> class MaxPolicy>
+const Index CompactUF<Index, MaxPolicy>::max_size;
+
+/**
+ * Weighted quick union without path compression, whose joins can be undone in reverse order.
+ *
+ * Every join that links two roots pushes the root it linked on a history stack. checkpoint() returns the
+ * current depth of the stack and rollback(checkpoint) unlinks the roots pushed since then, restoring the
+ * component sizes. Without path compression root still takes O(log n), as union by size keeps trees shallow,
+ * and a join only changes the two words an undo has to restore.
+ */
+class RollbackUF {
+public:
+    RollbackUF (unsigned long n) : parents(n), ranks(n, 1), size(n) {
+        std::iota(parents.begin(), parents.end(), 0UL);
+    }
+
+    // Returns true if a and b were in different components.
+    bool join(unsigned long a, unsigned long b) {
+        unsigned long a_component = root(a);
+        unsigned long b_component = root(b);
+        if (a_component == b_component) return false;
+        if (ranks[a_component] > ranks[b_component]) std::swap(a_component, b_component);
+        parents[a_component] = b_component;
+        ranks[b_component] += ranks[a_component];
+        history.push_back(a_component);
+        size--;
+        return true;
+    }
+
+    unsigned long root(unsigned long a) {
+        while (a != parents[a]) {
+            a = parents[a];
+        }
+        return a;
+    }
+
+    bool connected(unsigned long a, unsigned long b) {
+        return root(a) == root(b);
+    }
+
+    unsigned long find(unsigned long a) {
+        return root(a);
+    }
+
+    unsigned long findComponentMax(unsigned long a) {
+        // Not implemented.
+        return 0;
+    }
+
+    unsigned long count() {
+        return size;
+    }
+
+    size_t checkpoint() {
+        return history.size();
+    }
+
+    // Undoes the joins made after checkpoint was taken, newest first.
+    void rollback(size_t checkpoint) {
+        assert(checkpoint <= history.size());
+        while (history.size() > checkpoint) {
+            unsigned long linked = history.back();
+            history.pop_back();
+            unsigned long parent = parents[linked];
+            ranks[parent] -= ranks[linked];
+            parents[linked] = linked;
+            size++;
+        }
+    }
+
+private:
+    std::vector<unsigned long> parents;
+    std::vector<unsigned long> ranks;
+    std::vector<unsigned long> history;
+    unsigned long size;
+};
+
+/**
+ * The integers 0 to n - 1, from which integers are removed, with the smallest remaining integer >= i and the
+ * largest <= i, e.g. free ids to allocate. successor and predecessor return n when there is none.
+ */
 class SuccessorOfIncreasingNumbers {
 public:
-    SuccessorOfIncreasingNumbers(unsigned long n) : uf(n) {};
+    SuccessorOfIncreasingNumbers(unsigned long n) : remaining(n, true) {};
+
+    void remove(unsigned long i) {
+        remaining.remove(i);
+    }
+
+    // Puts a removed integer back, e.g. an id that is freed.
+    void restore(unsigned long i) {
+        remaining.insert(i);
+    }
+
+    unsigned long successor(unsigned long i) {
+        return remaining.successor(i);
+    }
+
+    unsigned long predecessor(unsigned long i) {
+        return remaining.predecessor(i);
+    }
+
+private:
+    SuccessorSet remaining;
+};
+
+// Successor with delete on a union-find: a removed integer is joined with the next one, and the maximum of a
+// component is the successor of all of its integers. n, never removed, stands for no successor.
+class UFSuccessorOfIncreasingNumbers {
+public:
+    UFSuccessorOfIncreasingNumbers(unsigned long n) : uf(n + 1) {};
 
     void remove(unsigned long i) {
         uf.join(i, i + 1);
@@ -234,26 +555,157 @@ private:
     WeightedQuickUnionUF uf;
 };
 
+/**
+ * Lock-free union-find for many threads joining and querying at once, after Jayanti and Tarjan's concurrent
+ * disjoint set union.
+ *
+ * Parents are atomics. A join links the root of lower priority under the other one with a compare-and-swap,
+ * which fails and is retried if another thread linked that root in the meantime. Priorities are a fixed
+ * pseudo random permutation of the indices, which keeps trees logarithmically deep in expectation without
+ * storing ranks, whose updates could not be made atomically together with the link. Finds do path splitting,
+ * pointing every visited element to its grandparent with a compare-and-swap that may fail harmlessly.
+ */
+class ConcurrentUF {
+public:
+    ConcurrentUF (unsigned long n) : parents(n), size(n) {
+        for (unsigned long i = 0; i < n; i++) {
+            parents[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void join(unsigned long a, unsigned long b) {
+        while (true) {
+            a = root(a);
+            b = root(b);
+            if (a == b) return;
+            if (priority(a) > priority(b)) std::swap(a, b);
+            unsigned long expected = a;
+            if (parents[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+                size.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    unsigned long root(unsigned long a) {
+        while (true) {
+            unsigned long parent = parents[a].load(std::memory_order_acquire);
+            unsigned long grandparent = parents[parent].load(std::memory_order_acquire);
+            if (parent == grandparent) return parent;
+            parents[a].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+            a = parent;
+        }
+    }
+
+    bool connected(unsigned long a, unsigned long b) {
+        while (true) {
+            a = root(a);
+            b = root(b);
+            if (a == b) return true;
+            // a was a root when b's root was found, so they were in different components at that point.
+            if (parents[a].load(std::memory_order_acquire) == a) return false;
+        }
+    }
+
+    unsigned long find(unsigned long a) {
+        return root(a);
+    }
+
+    unsigned long findComponentMax(unsigned long a) {
+        // Not implemented, a maximum kept at the root cannot be merged atomically with the link.
+        return 0;
+    }
+
+    // Exact once all joins have returned.
+    unsigned long count() {
+        return size.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Bijective mix of the index, so that two different roots never have the same priority.
+    static unsigned long priority(unsigned long x) {
+        uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    std::vector<std::atomic<unsigned long> > parents;
+    std::atomic<unsigned long> size;
+};
+
+// Makes any union-find safe to share between threads by serializing every operation behind one mutex.
+template <typename Impl>
+class LockedUF {
+public:
+    LockedUF (unsigned long n) : uf(n) {}
+
+    void join(unsigned long a, unsigned long b) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uf.join(a, b);
+    }
+
+    bool connected(unsigned long a, unsigned long b) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return uf.connected(a, b);
+    }
+
+    unsigned long find(unsigned long a) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return uf.find(a);
+    }
+
+    unsigned long findComponentMax(unsigned long a) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return uf.findComponentMax(a);
+    }
+
+    unsigned long count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return uf.count();
+    }
+
+private:
+    Impl uf;
+    std::mutex mutex;
+};
+
+
+template <typename Impl>
+auto joinPairsImpl(PairFileReader& reader, Impl& uf, int)
+        -> decltype(uf.joinBatch((std::pair<unsigned long, unsigned long>*) nullptr,
+                                 (std::pair<unsigned long, unsigned long>*) nullptr), void()) {
+    reader.forEachBatch<unsigned long>([&uf](std::pair<unsigned long, unsigned long>* pairs, size_t count) {
+        uf.joinBatch(pairs, pairs + count);
+    });
+}
+
+template <typename Impl>
+void joinPairsImpl(PairFileReader& reader, Impl& uf, long) {
+    reader.forEachBatch<unsigned long>([&uf](std::pair<unsigned long, unsigned long>* pairs, size_t count) {
+        for (size_t i = 0; i < count; i++) uf.join(pairs[i].first, pairs[i].second);
+    });
+}
+
+// Joins the remaining pairs of reader, through joinBatch for the union-finds that have it.
+template <typename Impl>
+void joinPairs(PairFileReader& reader, Impl& uf) {
+    joinPairsImpl(reader, uf, 0);
+}
 
 template <typename Impl>
 int testUFImpl() {
-    std::fstream f;
-    f.open("data/mediumUF.txt", std::fstream::in);
-    if ( (f.rdstate() & std::ifstream::failbit ) != 0 ) {
+    PairFileReader reader("data/mediumUF.txt");
+    if (!reader.isOpen()) {
         std::cerr << "Error opening file.\n";
         return 1;
     }
 
     std::cout << measure<std::chrono::microseconds>::execution( [&]() {
         unsigned long n;
-        f >> n;
-        auto uf = Impl(n);
-
-        while(!f.eof()) {
-            unsigned long a, b;
-            f >> a >> b;
-            uf.join(a, b);
-        }
+        reader.readCount(n);
+        Impl uf(n);
+        joinPairs(reader, uf);
 
         bool connected = uf.connected(4, 3);
         std::cout << "Connected (3,5): " << connected << std::endl;
@@ -262,10 +714,70 @@ int testUFImpl() {
         std::cout << uf.findComponentMax(1) << std::endl;
     }) << std::endl;
 
-    f.close();
     return 0;
 }
 
+// Joins the same random pairs from several threads while other threads query, and compares the resulting
+// components with a sequential run.
+template <typename Impl>
+bool testConcurrentUFImpl(unsigned long threads) {
+    const unsigned long n = 100000;
+    std::mt19937_64 gen(11);
+    std::uniform_int_distribution<unsigned long> dist(0, n - 1);
+    std::vector<std::pair<unsigned long, unsigned long> > pairs(n);
+    for (auto& p : pairs) p = std::make_pair(dist(gen), dist(gen));
+
+    Impl uf(n);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> workers;
+    for (unsigned long t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (size_t i = t; i < pairs.size(); i += threads) uf.join(pairs[i].first, pairs[i].second);
+        });
+    }
+    std::thread reader([&]() {
+        unsigned long i = 0;
+        while (!done.load()) {
+            uf.connected(i % n, (i * 7919) % n);
+            i++;
+        }
+    });
+    for (auto& w : workers) w.join();
+    done = true;
+    reader.join();
+
+    WeightedQuickUnionUF expected(n);
+    for (auto& p : pairs) expected.join(p.first, p.second);
+    bool same = uf.count() == expected.count();
+    for (unsigned long i = 0; i + 1 < n && same; i++) {
+        same = uf.connected(i, i + 1) == expected.connected(i, i + 1);
+    }
+    return same;
+}
+
+// Checks that joinBatch and connectedBatch give the same answers as join and connected.
+template <typename Impl>
+bool testUFBatchImpl() {
+    const unsigned long n = 100000;
+    std::mt19937_64 gen(13);
+    std::uniform_int_distribution<unsigned long> dist(0, n - 1);
+    std::vector<std::pair<unsigned long, unsigned long> > pairs(n / 2 + 7), queries(n);
+    for (auto& p : pairs) p = std::make_pair(dist(gen), dist(gen));
+    for (auto& q : queries) q = std::make_pair(dist(gen), dist(gen));
+
+    Impl batched(n), expected(n);
+    batched.joinBatch(pairs.begin(), pairs.end());
+    for (auto& p : pairs) expected.join(p.first, p.second);
+    std::vector<bool> answers;
+    batched.connectedBatch(queries.begin(), queries.end(), std::back_inserter(answers));
+
+    bool same = batched.count() == expected.count() && answers.size() == queries.size();
+    for (size_t i = 0; i < queries.size() && same; i++) {
+        same = answers[i] == expected.connected(queries[i].first, queries[i].second);
+    }
+    return same;
+}
+
 int testUF() {
     std::cout << "Testing union find implementations.\n";
     std::cout << "Testing quick find.\n";
@@ -276,12 +788,53 @@ int testUF() {
     testUFImpl<WeightedQuickUnionUF>();
     std::cout << "Testing weighted quick union ranked by height.\n";
     testUFImpl<WeightedQuickUnionUFHeight>();
+    std::cout << "Batched joins and queries match single ones: " << testUFBatchImpl<WeightedQuickUnionUF>() << "\n";
+    std::cout << "Testing compact weighted quick union.\n";
+    testUFImpl<CompactUF<uint32_t, TrackComponentMax> >();
+    CompactUF<> compact(10);
+    compact.join(1, 2);
+    compact.join(3, 2);
+    compact.join(2, 2);
+    std::cout << "Components: " << compact.count() << ", size of the component of 3: " << compact.componentSize(3)
+              << "\n";
+    std::cout << "Batched joins and queries match single ones: " << testUFBatchImpl<CompactUF<> >() << "\n";
+    bool rejected = false;
+    try {
+        CompactUF<uint32_t> too_large(1UL << 31);
+    }
+    catch (const std::length_error&) {
+        rejected = true;
+    }
+    std::cout << "Compact union-find rejects 2^31 elements: " << rejected << "\n";
+
+    std::cout << "Testing union find with rollback.\n";
+    testUFImpl<RollbackUF>();
+    RollbackUF rollback(10);
+    rollback.join(1, 2);
+    auto checkpoint = rollback.checkpoint();
+    rollback.join(2, 3);
+    rollback.join(5, 1);
+    std::cout << "Before rollback: " << rollback.connected(3, 5) << " " << rollback.count() << ", ";
+    rollback.rollback(checkpoint);
+    std::cout << "after: " << rollback.connected(3, 5) << " " << rollback.connected(1, 2) << " "
+              << rollback.count() << "\n";
+
+    std::cout << "Testing concurrent union find.\n";
+    testUFImpl<ConcurrentUF>();
+    std::cout << "Joins from 4 threads match a sequential run: " << testConcurrentUFImpl<ConcurrentUF>(4) << "\n";
+    std::cout << "Testing mutex wrapped weighted quick union.\n";
+    std::cout << "Joins from 4 threads match a sequential run: "
+              << testConcurrentUFImpl<LockedUF<WeightedQuickUnionUF> >(4) << "\n";
 
     std::cout << "Test successors.\n";
     SuccessorOfIncreasingNumbers successors(10);
-    successors.remove(3);
-    successors.remove(4);
-    std::cout << successors.successor(3);
+    UFSuccessorOfIncreasingNumbers uf_successors(10);
+    for (unsigned long i : {3, 4, 9}) {
+        successors.remove(i);
+        uf_successors.remove(i);
+    }
+    std::cout << successors.successor(3) << " " << successors.successor(9) << " " << successors.predecessor(4)
+              << ", union find: " << uf_successors.successor(3) << " " << uf_successors.successor(9) << "\n";
     return 0;
 }
 